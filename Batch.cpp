@@ -0,0 +1,317 @@
+//
+//@brief: Implementations of the batch operations on spans of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Batch.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <string_view>
+#include "Kernel.h"
+#include "Memory.h"
+#include "Multiply.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+
+typedef BigInt::limb limb;
+
+const std::size_t LANES = 64;               // lanes per block, a multiple of every vector width
+const std::size_t BUCKETS = 4;              // buckets of up to 1, 2, 4 and 8 limbs
+const std::size_t MUL_BUCKETS = 1;          // products of single limbs are computed across lanes
+const std::size_t WINDOW = 1024;            // pairs sorted and processed together, a job of the pool
+const std::size_t PARALLEL_PAIRS = 4096;    // pairs from which a call uses the pool
+const limb DIGIT = 0xffffffff;
+
+//a block of lanes: the pairs index[0..count) of one bucket.
+struct Batch::Lanes {
+    std::span<const BigInt> a, b;
+    std::span<BigInt> out;
+    std::span<int> cmp;
+    const std::size_t *index;
+    std::size_t count;
+    std::size_t limbs;
+};
+
+//    The lane loops are written once and inlined into a copy per instruction set, the compiler
+//    vectorizes the inner loop over the lanes of a row. Row j of a block holds limb j of every lane.
+//    Signs come as masks, all ones for a negative lane.
+
+//x = (x ^ mask) + (mask & 1) per lane: the two's complement negation of the masked lanes.
+__attribute__((always_inline))
+static inline void negate_lanes(limb *x, std::size_t len, std::size_t w, const limb *mask) {
+    limb carry[LANES];
+    for (std::size_t i = 0; i < w; i++) { carry[i] = mask[i] & 1; }
+    for (std::size_t j = 0; j < len; j++) {
+        limb *row = x + j * w;
+        for (std::size_t i = 0; i < w; i++) {
+            limb v = (row[i] ^ mask[i]) + carry[i];
+            carry[i] = v < carry[i] ? 1 : 0;
+            row[i] = v;
+        }
+    }
+}
+
+//x + y of signed magnitudes into x, with one limb of headroom: the operands go to two's complement,
+//are added with a carry chain per lane, and the result comes back as its sign mask and magnitude.
+__attribute__((always_inline))
+static inline void linear_lanes(limb *x, const limb *y, std::size_t len, std::size_t w,
+                                const limb *sx, const limb *sy, limb *sr) {
+    negate_lanes(x, len, w, sx);
+    limb carry[LANES];
+    for (std::size_t i = 0; i < w; i++) { carry[i] = sy[i] & 1; }
+    for (std::size_t j = 0; j < len; j++) {
+        limb *row = x + j * w;
+        const limb *other = y + j * w;
+        for (std::size_t i = 0; i < w; i++) {
+            limb a = row[i], b = other[i] ^ sy[i];
+            limb s = a + b, t = s + carry[i];
+            carry[i] = (s < a ? 1 : 0) | (t < s ? 1 : 0);
+            row[i] = t;
+        }
+    }
+    const limb *top = x + (len - 1) * w;
+    for (std::size_t i = 0; i < w; i++) { sr[i] = 0 - (top[i] >> 63); }
+    negate_lanes(x, len, w, sr);
+}
+
+//r = x * y of magnitudes of len limbs per lane, in 32 bit digits: products of two digits fit a
+//limb, and the low and high halves are summed in separate columns so the sums cannot overflow.
+__attribute__((always_inline))
+static inline void mul_lanes(limb *r, const limb *x, const limb *y, std::size_t len, std::size_t w, limb *work) {
+    const std::size_t digits = 2 * len, columns = 2 * digits;
+    limb *dx = work, *dy = dx + digits * w, *lo = dy + digits * w, *hi = lo + columns * w;
+    for (std::size_t j = 0; j < len; j++) {
+        for (std::size_t i = 0; i < w; i++) {
+            dx[2 * j * w + i] = x[j * w + i] & DIGIT;
+            dx[(2 * j + 1) * w + i] = x[j * w + i] >> 32;
+            dy[2 * j * w + i] = y[j * w + i] & DIGIT;
+            dy[(2 * j + 1) * w + i] = y[j * w + i] >> 32;
+        }
+    }
+    std::fill(lo, lo + 2 * columns * w, 0);
+    for (std::size_t p = 0; p < digits; p++) {
+        for (std::size_t q = 0; q < digits; q++) {
+            limb *l = lo + (p + q) * w, *h = hi + (p + q) * w;
+            const limb *u = dx + p * w, *v = dy + q * w;
+            for (std::size_t i = 0; i < w; i++) {
+                limb prod = (u[i] & DIGIT) * (v[i] & DIGIT);
+                l[i] += prod & DIGIT;
+                h[i] += prod >> 32;
+            }
+        }
+    }
+    limb carry[LANES] = {};
+    for (std::size_t k = 0; k < columns; k++) {
+        limb *out = r + (k / 2) * w;
+        const limb *l = lo + k * w, *h = k > 0 ? hi + (k - 1) * w : nullptr;
+        for (std::size_t i = 0; i < w; i++) {
+            limb v = l[i] + (h != nullptr ? h[i] : 0) + carry[i];
+            carry[i] = v >> 32;
+            if (k % 2 == 0) { out[i] = v & DIGIT; }
+            else { out[i] |= (v & DIGIT) << 32; }
+        }
+    }
+}
+
+struct LaneKernels {
+    void (*linear)(limb *, const limb *, std::size_t, std::size_t, const limb *, const limb *, limb *);
+    void (*mul)(limb *, const limb *, const limb *, std::size_t, std::size_t, limb *);
+};
+
+#define BATCH_LANE_KERNELS(NAME, TARGET) \
+    TARGET static void linear_##NAME(limb *x, const limb *y, std::size_t len, std::size_t w, \
+                                     const limb *sx, const limb *sy, limb *sr) { \
+        linear_lanes(x, y, len, w, sx, sy, sr); \
+    } \
+    TARGET static void mul_##NAME(limb *r, const limb *x, const limb *y, std::size_t len, std::size_t w, limb *work) { \
+        mul_lanes(r, x, y, len, w, work); \
+    }
+
+BATCH_LANE_KERNELS(scalar, )
+#if defined(__x86_64__) || defined(__i386__)
+BATCH_LANE_KERNELS(avx2, __attribute__((target("avx2"))))
+BATCH_LANE_KERNELS(avx512, __attribute__((target("avx512f"))))
+#endif
+
+//the copy for the instruction set the limb kernels picked, so BIGINT_SIMD applies here too.
+static const LaneKernels &lane_kernels() {
+    static const LaneKernels selected = [] {
+        std::string_view level = kernel::simd_level();
+#if defined(__x86_64__) || defined(__i386__)
+        if (level == "avx512") { return LaneKernels{linear_avx512, mul_avx512}; }
+        if (level == "avx2") { return LaneKernels{linear_avx2, mul_avx2}; }
+#endif
+        return LaneKernels{linear_scalar, mul_scalar};
+    }();
+    return selected;
+}
+
+void Batch::add(std::span<const BigInt> a, std::span<const BigInt> b, std::span<BigInt> out) {
+    run(Op::Add, a, b, out, {});
+}
+
+void Batch::sub(std::span<const BigInt> a, std::span<const BigInt> b, std::span<BigInt> out) {
+    run(Op::Sub, a, b, out, {});
+}
+
+void Batch::mul(std::span<const BigInt> a, std::span<const BigInt> b, std::span<BigInt> out) {
+    run(Op::Mul, a, b, out, {});
+}
+
+void Batch::compare(std::span<const BigInt> a, std::span<const BigInt> b, std::span<int> out) {
+//    out[i] = -1, 0 or 1 as a[i] is below, equal to or above b[i].
+    run(Op::Compare, a, b, {}, out);
+}
+
+void Batch::run(Op op, std::span<const BigInt> a, std::span<const BigInt> b, std::span<BigInt> out,
+                std::span<int> cmp) {
+    const std::size_t n = a.size();
+    if (b.size() != n || (op == Op::Compare ? cmp.size() : out.size()) != n) {
+        throw "Batch operands differ in length.";
+    }
+    BIGINT_STAT_OP(Batch, stats::active.load(std::memory_order_relaxed) ? longer_limbs(a, b) : 0);
+
+//    The pairs go window by window, so sorting a window and gathering its lanes find the numbers
+//    still in cache. Windows are independent and spread over the pool when there are enough pairs.
+    const std::size_t windows = (n + WINDOW - 1) / WINDOW;
+    auto body = [&](std::size_t k) {
+        const std::size_t begin = k * WINDOW, len = std::min(WINDOW, n - begin);
+        window(op, a.subspan(begin, len), b.subspan(begin, len),
+               op == Op::Compare ? std::span<BigInt>() : out.subspan(begin, len),
+               op == Op::Compare ? cmp.subspan(begin, len) : std::span<int>());
+    };
+    std::shared_ptr<ThreadPool> pool = n >= PARALLEL_PAIRS ? parallel_pool() : nullptr;
+    if (pool) { pool->parallel_for(windows, body); }
+    else {
+        for (std::size_t k = 0; k < windows; k++) { body(k); }
+    }
+}
+
+//the pairs of one window, sorted into buckets by length.
+void Batch::window(Op op, std::span<const BigInt> a, std::span<const BigInt> b, std::span<BigInt> out,
+                          std::span<int> cmp) {
+//    Counting sort of the pairs by bucket, bucket k holding the pairs whose longer operand has at
+//    most 2^k limbs and the last one the pairs left to the single-number path.
+    const std::size_t n = a.size(), buckets = op == Op::Mul ? MUL_BUCKETS : BUCKETS;
+    if (op == Op::Compare) {
+//        A comparison mostly stops at the signs or the top limbs, gathering whole lanes costs more.
+        for (std::size_t k = 0; k < n; k++) { single(op, a[k], b[k], nullptr, &cmp[k]); }
+        return;
+    }
+    memory::Scratch scratch;
+    unsigned char *bucket = scratch.take<unsigned char>(n);
+    std::size_t *index = scratch.take<std::size_t>(n);
+    std::size_t count[BUCKETS + 2] = {};
+    for (std::size_t k = 0; k < n; k++) {
+        std::size_t len = std::max(a[k].limbs.size(), b[k].limbs.size());
+        bucket[k] = static_cast<unsigned char>(std::min<std::size_t>(len <= 1 ? 0 : std::bit_width(len - 1), buckets));
+        count[bucket[k] + 1]++;
+    }
+    for (std::size_t k = 0; k <= buckets; k++) { count[k + 1] += count[k]; }
+    std::size_t start[BUCKETS + 2];
+    std::copy(count, count + buckets + 2, start);
+    for (std::size_t k = 0; k < n; k++) { index[count[bucket[k]]++] = k; }
+
+    for (std::size_t k = 0; k < buckets; k++) {
+        for (std::size_t s = start[k]; s < start[k + 1]; s += LANES) {
+            const std::size_t w = std::min(LANES, start[k + 1] - s);
+            block(op, Lanes{a, b, out, cmp, index + s, w, std::size_t(1) << k});
+        }
+    }
+    for (std::size_t s = start[buckets]; s < n; s++) {
+        std::size_t i = index[s];
+        single(op, a[i], b[i], op == Op::Compare ? nullptr : &out[i], op == Op::Compare ? &cmp[i] : nullptr);
+    }
+}
+
+//the limbs of the longer operand of every pair, added up: the size a batch is counted with.
+std::size_t Batch::longer_limbs(std::span<const BigInt> a, std::span<const BigInt> b) {
+    std::size_t total = 0;
+    for (std::size_t k = 0; k < a.size(); k++) { total += std::max(a[k].limbs.size(), b[k].limbs.size()); }
+    return total;
+}
+
+void Batch::block(Op op, const Lanes &l) {
+    const std::size_t w = l.count;
+    const LaneKernels &kernels = lane_kernels();
+    memory::Scratch scratch;
+    limb sx[LANES], sy[LANES], sr[LANES];
+    if (op == Op::Add || op == Op::Sub) {
+//        One more limb than the bucket holds the carry and the sign of the two's complement sum.
+        const std::size_t len = l.limbs + 1;
+        limb *x = scratch.take<limb>(len * w), *y = scratch.take<limb>(len * w);
+        gather(l.a, l, len, x, sx);
+        gather(l.b, l, len, y, sy);
+        if (op == Op::Sub) {
+            for (std::size_t i = 0; i < w; i++) { sy[i] = ~sy[i]; }
+        }
+        kernels.linear(x, y, len, w, sx, sy, sr);
+        scatter(l, x, len, sr);
+    } else {
+        const std::size_t len = l.limbs;
+        limb *x = scratch.take<limb>(len * w), *y = scratch.take<limb>(len * w);
+        limb *r = scratch.take<limb>(2 * len * w), *work = scratch.take<limb>(12 * len * w);
+        gather(l.a, l, len, x, sx);
+        gather(l.b, l, len, y, sy);
+        kernels.mul(r, x, y, len, w, work);
+        for (std::size_t i = 0; i < w; i++) { sr[i] = sx[i] ^ sy[i]; }
+        scatter(l, r, 2 * len, sr);
+    }
+}
+
+//soa[j * count + i] = limb j of the magnitude of x[index[i]], zero past its length, and its sign mask.
+void Batch::gather(std::span<const BigInt> x, const Lanes &l, std::size_t len, limb *soa, limb *signs) {
+    const std::size_t w = l.count;
+    std::fill(soa, soa + len * w, 0);
+    for (std::size_t i = 0; i < w; i++) {
+        const BigInt &v = x[l.index[i]];
+        for (std::size_t j = 0; j < v.limbs.size(); j++) { soa[j * w + i] = v.limbs[j]; }
+        signs[i] = v.negative ? ~limb(0) : 0;
+    }
+}
+
+//out[index[i]] = the magnitude in lane i of soa with the sign mask signs[i], in the storage it has.
+void Batch::scatter(const Lanes &l, const limb *soa, std::size_t len, const limb *signs) {
+    const std::size_t w = l.count;
+    for (std::size_t i = 0; i < w; i++) {
+        std::size_t size = len;
+        while (size > 0 && soa[(size - 1) * w + i] == 0) { size--; }
+        BigInt &r = l.out[l.index[i]];
+        r.limbs.resize(size);
+        for (std::size_t j = 0; j < size; j++) { r.limbs[j] = soa[j * w + i]; }
+        r.negative = signs[i] != 0 && size > 0;
+    }
+}
+
+//one pair through the single-number kernels, out may be x or y.
+void Batch::single(Op op, const BigInt &x, const BigInt &y, BigInt *out, int *cmp) {
+    if (op == Op::Compare) {
+        int c = x.cmp(y);
+        *cmp = c == 2 ? 0 : c == 1 ? -1 : 1;
+    } else if (op == Op::Mul) {
+        const bool negative = x.negative != y.negative;
+        if (x.limbs.empty() || y.limbs.empty()) {
+            out->limbs.clear();
+        } else {
+            const std::size_t n = x.limbs.size(), m = y.limbs.size();
+            memory::Scratch scratch;
+            limb *product = scratch.take<limb>(n + m);
+            multiply_limbs(product, x.limbs.data(), n, y.limbs.data(), m);
+            out->limbs.assign(product, product + n + m);
+        }
+        out->negative = negative;
+        out->normalize();
+    } else if (out == &y && out != &x) {
+//        y + x, or y - x negated.
+        out->accumulate(x, op == Op::Sub);
+        if (op == Op::Sub) { out->negative = !out->negative && !out->limbs.empty(); }
+    } else {
+        if (out != &x) { *out = x; }
+        out->accumulate(y, op == Op::Sub);
+    }
+}
@@ -0,0 +1,63 @@
+//
+//@brief: Definitions for the batch operations on spans of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_BATCH_H
+#define BIGINT_BATCH_H
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include "BigInt.h"
+
+class Batch {
+    /**
+     *  One operation applied to many independent pairs: out[i] = a[i] + b[i] and so on, for spans of
+     * the same length. The pairs are bucketed by length and each bucket is processed a block of lanes
+     * at a time in structure-of-arrays layout, limb j of every lane side by side. The carry chains
+     * then run across lanes in the vector registers instead of along one number, signs become two's
+     * complement masks instead of branches, and results go into the storage out[i] already has.
+     * Products of single limbs are computed across lanes as well, in 32 bit digits.
+     *  Pairs too long for a bucket, longer products and comparisons, which mostly stop at the signs
+     * or the top limbs, go through the single-number kernels. Calls with enough pairs spread their
+     * windows over the BigInt thread pool.
+     *  out[i] may be a[i] or b[i], but must not overlap the operands of any other pair.
+     */
+public:
+    static void add(std::span<const BigInt>, std::span<const BigInt>, std::span<BigInt>);
+
+    static void sub(std::span<const BigInt>, std::span<const BigInt>, std::span<BigInt>);
+
+    static void mul(std::span<const BigInt>, std::span<const BigInt>, std::span<BigInt>);
+
+    static void compare(std::span<const BigInt>, std::span<const BigInt>, std::span<int>);
+
+private:
+    enum class Op {
+        Add, Sub, Mul, Compare
+    };
+
+    struct Lanes;
+
+    static void run(Op, std::span<const BigInt>, std::span<const BigInt>, std::span<BigInt>, std::span<int>);
+
+    static void window(Op, std::span<const BigInt>, std::span<const BigInt>, std::span<BigInt>, std::span<int>);
+
+    static std::size_t longer_limbs(std::span<const BigInt>, std::span<const BigInt>);
+
+    static void block(Op, const Lanes &);
+
+    static void gather(std::span<const BigInt>, const Lanes &, std::size_t, BigInt::limb *, BigInt::limb *);
+
+    static void scatter(const Lanes &, const BigInt::limb *, std::size_t, const BigInt::limb *);
+
+    static void single(Op, const BigInt &, const BigInt &, BigInt *, int *);
+};
+
+
+#endif //BIGINT_BATCH_H
@@ -0,0 +1,376 @@
+//
+//@brief: Implementations of BigDecimal.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "BigDecimal.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include "Divide.h"
+#include "Kernel.h"
+#include "Stats.h"
+
+typedef BigInt::limb limb;
+
+const long long WORD_DIGITS = 19;       // 10^19 is the largest power of ten in a limb
+const long long WORD_PASSES = 8;        // powers up to 10^(19 * 8) go a word at a time
+const limb POWERS_OF_TEN[WORD_DIGITS + 1] = {
+        1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+        1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+        100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+        1000000000000000000ull, 10000000000000000000ull
+};
+
+static std::atomic<int> division_scale(20);
+
+std::istream &operator>>(std::istream &in, BigDecimal &x) {
+//    Use operator>> to input.
+    std::string tmp;
+    if (in >> tmp) { x = BigDecimal::from_string(tmp); }
+    return in;
+}
+
+std::ostream &operator<<(std::ostream &out, const BigDecimal &x) {
+//    Use operator<< to output.
+    out << x.to_string();
+    return out;
+}
+
+BigDecimal operator+(const BigDecimal &a, const BigDecimal &b) {
+    BigDecimal result = a;
+    result += b;
+    return result;
+}
+
+BigDecimal operator-(const BigDecimal &a, const BigDecimal &b) {
+    BigDecimal result = a;
+    result -= b;
+    return result;
+}
+
+BigDecimal operator*(const BigDecimal &a, const BigDecimal &b) {
+//    Mantissas multiply and scales add, nothing is rounded.
+    return BigDecimal(a.mantissa * b.mantissa, BigDecimal::checked_scale(static_cast<long long>(a.exponent) + b.exponent));
+}
+
+BigDecimal operator/(const BigDecimal &a, const BigDecimal &b) {
+    return a.divide(b, std::max({a.exponent, b.exponent, BigDecimal::default_scale()}));
+}
+
+BigDecimal &operator+=(BigDecimal &a, const BigDecimal &b) {
+//    The operand with the smaller scale is brought up to the other one, the sum is exact.
+    if (a.exponent == b.exponent) {
+        a.mantissa += b.mantissa;
+    } else if (a.exponent > b.exponent) {
+        BigInt y = b.mantissa;
+        BigDecimal::scale_up(y, static_cast<long long>(a.exponent) - b.exponent);
+        a.mantissa += y;
+    } else {
+        BigDecimal::scale_up(a.mantissa, static_cast<long long>(b.exponent) - a.exponent);
+        a.exponent = b.exponent;
+        a.mantissa += b.mantissa;
+    }
+    return a;
+}
+
+BigDecimal &operator-=(BigDecimal &a, const BigDecimal &b) {
+    if (a.exponent == b.exponent) {
+        a.mantissa -= b.mantissa;
+    } else if (a.exponent > b.exponent) {
+        BigInt y = b.mantissa;
+        BigDecimal::scale_up(y, static_cast<long long>(a.exponent) - b.exponent);
+        a.mantissa -= y;
+    } else {
+        BigDecimal::scale_up(a.mantissa, static_cast<long long>(b.exponent) - a.exponent);
+        a.exponent = b.exponent;
+        a.mantissa -= b.mantissa;
+    }
+    return a;
+}
+
+BigDecimal &operator*=(BigDecimal &a, const BigDecimal &b) {
+    a.exponent = BigDecimal::checked_scale(static_cast<long long>(a.exponent) + b.exponent);
+    a.mantissa *= b.mantissa;
+    return a;
+}
+
+BigDecimal &operator/=(BigDecimal &a, const BigDecimal &b) {
+    a = a / b;
+    return a;
+}
+
+bool operator==(const BigDecimal &a, const BigDecimal &b) {
+    return BigDecimal::compare(a, b) == 0;
+}
+
+bool operator!=(const BigDecimal &a, const BigDecimal &b) {
+    return BigDecimal::compare(a, b) != 0;
+}
+
+bool operator<(const BigDecimal &a, const BigDecimal &b) {
+    return BigDecimal::compare(a, b) < 0;
+}
+
+bool operator>(const BigDecimal &a, const BigDecimal &b) {
+    return BigDecimal::compare(a, b) > 0;
+}
+
+bool operator<=(const BigDecimal &a, const BigDecimal &b) {
+    return BigDecimal::compare(a, b) <= 0;
+}
+
+bool operator>=(const BigDecimal &a, const BigDecimal &b) {
+    return BigDecimal::compare(a, b) >= 0;
+}
+
+BigDecimal::BigDecimal(const BigInt &unscaled, int scale) : mantissa(unscaled), exponent(scale) {}
+
+BigDecimal::BigDecimal(BigInt &&unscaled, int scale) : mantissa(std::move(unscaled)), exponent(scale) {}
+
+BigDecimal::BigDecimal(const std::string &s) {
+    *this = from_string(s);
+}
+
+const BigInt &BigDecimal::unscaled() const {
+    return this->mantissa;
+}
+
+int BigDecimal::scale() const {
+    return this->exponent;
+}
+
+int BigDecimal::precision() const {
+//    Number of decimal digits of the unscaled value.
+    return this->mantissa.size();
+}
+
+std::string BigDecimal::to_string() const {
+//    Plain notation: the point goes scale digits from the right, a negative scale appends zeros.
+    std::string s = this->mantissa.to_string();
+    const std::size_t sign = this->mantissa.negative ? 1 : 0;
+    if (this->exponent > 0) {
+        const std::size_t digits = s.size() - sign, point = static_cast<std::size_t>(this->exponent);
+        if (digits <= point) { s.insert(sign, point + 1 - digits, '0'); }
+        s.insert(s.size() - point, 1, '.');
+    } else if (this->exponent < 0 && !this->mantissa.limbs.empty()) {
+        s.append(static_cast<std::size_t>(-static_cast<long long>(this->exponent)), '0');
+    }
+    return s;
+}
+
+BigDecimal BigDecimal::from_string(const std::string &s) {
+//    An optional sign, digits with an optional point, and an optional exponent as in 1.5e-3.
+    std::size_t pos = 0;
+    bool neg = false;
+    if (pos < s.size() && (s[pos] == '+' || s[pos] == '-')) { neg = s[pos++] == '-'; }
+    std::string digits;
+    long long scale = 0;
+    bool point = false;
+    for (; pos < s.size() && s[pos] != 'e' && s[pos] != 'E'; pos++) {
+        if (s[pos] == '.' && !point) {
+            point = true;
+        } else if (s[pos] >= '0' && s[pos] <= '9') {
+            digits.push_back(s[pos]);
+            scale += point ? 1 : 0;
+        } else {
+            throw "Invalid number format.";
+        }
+    }
+    if (digits.empty()) { throw "Invalid number format."; }
+    if (pos < s.size()) {
+        pos++;
+        bool eneg = false;
+        if (pos < s.size() && (s[pos] == '+' || s[pos] == '-')) { eneg = s[pos++] == '-'; }
+        if (pos == s.size()) { throw "Invalid number format."; }
+        long long e = 0;
+        for (; pos < s.size(); pos++) {
+            if (s[pos] < '0' || s[pos] > '9') { throw "Invalid number format."; }
+            e = std::min<long long>(e * 10 + (s[pos] - '0'), static_cast<long long>(INT_MAX) * 4);
+        }
+        scale -= eneg ? -e : e;
+    }
+    BigDecimal result(BigInt::from_string(digits), checked_scale(scale));
+    result.mantissa.negative = neg && !result.mantissa.limbs.empty();
+    return result;
+}
+
+BigInt BigDecimal::to_integer(Rounding mode) const {
+    return this->rescale(0, mode).mantissa;
+}
+
+BigDecimal BigDecimal::rescale(int scale, Rounding mode) const {
+//    A larger scale appends zero digits, a smaller one drops digits and rounds.
+    BigDecimal result = *this;
+    const long long k = static_cast<long long>(scale) - this->exponent;
+    if (k >= 0) { scale_up(result.mantissa, k); }
+    else { scale_down(result.mantissa, -k, mode); }
+    result.exponent = scale;
+    return result;
+}
+
+BigDecimal BigDecimal::strip_zeros() const {
+//    The same value with the trailing zero digits of the unscaled value taken into the scale.
+    BigDecimal result = *this;
+    if (result.mantissa.limbs.empty()) {
+        result.exponent = 0;
+        return result;
+    }
+    while (result.exponent >= INT_MIN + WORD_DIGITS && result.mantissa.mod_small(POWERS_OF_TEN[WORD_DIGITS]) == 0) {
+        result.mantissa.divmod_small(POWERS_OF_TEN[WORD_DIGITS]);
+        result.exponent -= WORD_DIGITS;
+    }
+    while (result.exponent > INT_MIN && result.mantissa.mod_small(10) == 0) {
+        result.mantissa.divmod_small(10);
+        result.exponent--;
+    }
+    return result;
+}
+
+BigDecimal BigDecimal::divide(const BigDecimal &x, int scale, Rounding mode) const {
+//    The quotient rounded to the given scale: q = this.unscaled * 10^e / x.unscaled with the power
+//    of ten e making up the difference in scales, and the remainder deciding the rounding.
+    BIGINT_STAT_OP(Divide, std::max(this->mantissa.limbs.size(), x.mantissa.limbs.size()));
+    if (x.mantissa.limbs.empty()) { throw "Can't divide by zero."; }
+    const bool negative = this->mantissa.negative != x.mantissa.negative;
+    const long long e = static_cast<long long>(scale) - this->exponent + x.exponent;
+    BigInt num = this->mantissa, den = x.mantissa;
+    num.negative = false;
+    den.negative = false;
+    if (e >= 0) { scale_up(num, e); }
+    else { scale_up(den, -e); }
+
+    BigDecimal result(BigInt(), scale);
+    Limbs rem;
+    if (num.limbs.empty()) {
+        return result;
+    } else if (den.limbs.size() == 1) {
+//        A word divisor, the common case of dividing by a count or a rate, is a single pass.
+        limb r = num.divmod_small(den.limbs[0]);
+        result.mantissa = std::move(num);
+        if (r != 0) { rem.push_back(r); }
+    } else {
+        divide_limbs(num.limbs, den.limbs, result.mantissa.limbs, rem);
+    }
+    result.mantissa.negative = negative;
+    result.mantissa.normalize();
+    round_quotient(result.mantissa, compare_half(rem, den.limbs), !rem.empty(), negative, mode);
+    return result;
+}
+
+void BigDecimal::set_default_scale(int scale) {
+//    The scale a / b rounds to at least, 20 by default.
+    division_scale.store(scale, std::memory_order_relaxed);
+}
+
+int BigDecimal::default_scale() {
+    return division_scale.load(std::memory_order_relaxed);
+}
+
+//compare the values of a and b, return -1, 0 or 1.
+int BigDecimal::compare(const BigDecimal &a, const BigDecimal &b) {
+    const bool an = a.mantissa.negative, bn = b.mantissa.negative;
+    if (an != bn) { return an ? -1 : 1; }
+    if (a.mantissa.limbs.empty() || b.mantissa.limbs.empty()) {
+        return a.mantissa.limbs.empty() ? (b.mantissa.limbs.empty() ? 0 : (bn ? 1 : -1)) : (an ? -1 : 1);
+    }
+    int c;
+    if (a.exponent == b.exponent) {
+        c = a.mantissa == b.mantissa ? 0 : (a.mantissa < b.mantissa ? -1 : 1);
+    } else if (a.exponent > b.exponent) {
+        BigInt y = b.mantissa;
+        scale_up(y, static_cast<long long>(a.exponent) - b.exponent);
+        c = a.mantissa == y ? 0 : (a.mantissa < y ? -1 : 1);
+    } else {
+        BigInt x = a.mantissa;
+        scale_up(x, static_cast<long long>(b.exponent) - a.exponent);
+        c = x == b.mantissa ? 0 : (x < b.mantissa ? -1 : 1);
+    }
+    return c;
+}
+
+//the scale s as an int, throw when it does not fit.
+int BigDecimal::checked_scale(long long s) {
+    if (s < INT_MIN || s > INT_MAX) { throw "Scale out of range."; }
+    return static_cast<int>(s);
+}
+
+//m *= 10^k, a word at a time for short powers and by the power itself for long ones.
+void BigDecimal::scale_up(BigInt &m, long long k) {
+    if (k == 0 || m.limbs.empty()) { return; }
+    if (k > WORD_DIGITS * WORD_PASSES) {
+        if (k > INT_MAX) { throw "Scale out of range."; }
+        m *= pow(BigInt(10), static_cast<int>(k));
+        return;
+    }
+    for (; k > 0; k -= std::min(k, WORD_DIGITS)) { m.mul_small(POWERS_OF_TEN[std::min(k, WORD_DIGITS)]); }
+}
+
+//m /= 10^k rounded with the given mode.
+void BigDecimal::scale_down(BigInt &m, long long k, Rounding mode) {
+    if (k == 0 || m.limbs.empty()) { return; }
+    const bool negative = m.negative;
+    if (k <= WORD_DIGITS) {
+//        10^k is even, so the remainder is compared with half of it directly.
+        const limb half = POWERS_OF_TEN[k] / 2, r = m.divmod_small(POWERS_OF_TEN[k]);
+        round_quotient(m, r < half ? -1 : r == half ? 0 : 1, r != 0, negative, mode);
+        return;
+    }
+    if (k > 20 * static_cast<long long>(m.limbs.size())) {
+//        |m| < 2^(64n) < 10^(20n) <= 10^(k - 1): the quotient is zero and below half way.
+        m.limbs.clear();
+        m.negative = false;
+        round_quotient(m, -1, true, negative, mode);
+        return;
+    }
+    BigInt d = pow(BigInt(10), static_cast<int>(k));
+    Limbs q, r;
+    divide_limbs(m.limbs, d.limbs, q, r);
+    m.limbs.swap(q);
+    m.normalize();
+    round_quotient(m, compare_half(r, d.limbs), !r.empty(), negative, mode);
+}
+
+//compare 2 * r with d of magnitudes, return -1, 0 or 1.
+int BigDecimal::compare_half(const Limbs &r, const Limbs &d) {
+    if (r.empty()) { return -1; }
+    Limbs twice(r.begin(), r.end());
+    limb carry = kernel::add_n(twice.data(), twice.data(), twice.data(), twice.size());
+    if (carry != 0) { twice.push_back(carry); }
+    if (twice.size() != d.size()) { return twice.size() < d.size() ? -1 : 1; }
+    return kernel::cmp_n(twice.data(), d.data(), d.size());
+}
+
+//step the truncated quotient q one unit away from zero when the mode asks for it. half tells how
+//the dropped part compares with half a unit, inexact whether it is non-zero, negative the sign of
+//the exact quotient.
+void BigDecimal::round_quotient(BigInt &q, int half, bool inexact, bool negative, Rounding mode) {
+    bool away = false;
+    switch (mode) {
+        case Rounding::Down:
+            break;
+        case Rounding::Up:
+            away = inexact;
+            break;
+        case Rounding::Floor:
+            away = inexact && negative;
+            break;
+        case Rounding::Ceiling:
+            away = inexact && !negative;
+            break;
+        case Rounding::HalfUp:
+            away = half >= 0;
+            break;
+        case Rounding::HalfDown:
+            away = half > 0;
+            break;
+        case Rounding::HalfEven:
+            away = half > 0 || (half == 0 && !q.limbs.empty() && (q.limbs[0] & 1) != 0);
+            break;
+    }
+    if (away) { q.accumulate_small(1, negative); }
+}
@@ -0,0 +1,128 @@
+//
+//@brief: Definitions for BigDecimal, a decimal number of any precision built on BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_BIGDECIMAL_H
+#define BIGINT_BIGDECIMAL_H
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include "BigInt.h"
+
+class BigDecimal {
+    /**
+     *  A decimal number unscaled * 10^-scale: a BigInt mantissa and an int scale, the number of
+     * digits after the point (negative for trailing zeros before it). 1.50 is 150 with scale 2, so
+     * the digits a value was given with are kept, and 1.5 == 1.50 compares equal.
+     *  + - * are exact, the scale of the result being the larger scale for + - and the sum of the
+     * scales for *. A quotient rarely is, so divide() takes the scale to round it to and how to
+     * round; a / b rounds half to even at the larger of the scales of a, b and default_scale().
+     * rescale() changes the scale, exactly when it grows and rounding when it shrinks, e.g.
+     * (a * b).rescale(2, BigDecimal::Rounding::HalfUp) for a product rounded to cents.
+     *  Powers of ten up to 10^19 are a single pass over the limbs with a word, larger ones go a few
+     * words at a time or through one multiplication or division by the power.
+     */
+    friend std::istream &operator>>(std::istream &, BigDecimal &);
+
+    friend std::ostream &operator<<(std::ostream &, const BigDecimal &);
+
+    friend BigDecimal operator+(const BigDecimal &, const BigDecimal &);
+
+    friend BigDecimal operator-(const BigDecimal &, const BigDecimal &);
+
+    friend BigDecimal operator*(const BigDecimal &, const BigDecimal &);
+
+    friend BigDecimal operator/(const BigDecimal &, const BigDecimal &);
+
+    friend BigDecimal &operator+=(BigDecimal &, const BigDecimal &);
+
+    friend BigDecimal &operator-=(BigDecimal &, const BigDecimal &);
+
+    friend BigDecimal &operator*=(BigDecimal &, const BigDecimal &);
+
+    friend BigDecimal &operator/=(BigDecimal &, const BigDecimal &);
+
+    friend bool operator==(const BigDecimal &, const BigDecimal &);
+
+    friend bool operator!=(const BigDecimal &, const BigDecimal &);
+
+    friend bool operator<(const BigDecimal &, const BigDecimal &);
+
+    friend bool operator>(const BigDecimal &, const BigDecimal &);
+
+    friend bool operator<=(const BigDecimal &, const BigDecimal &);
+
+    friend bool operator>=(const BigDecimal &, const BigDecimal &);
+
+public:
+    enum class Rounding {
+        Down,       // toward zero, dropping the digits
+        Up,         // away from zero when any dropped digit is not zero
+        Floor,      // toward negative infinity
+        Ceiling,    // toward positive infinity
+        HalfUp,     // to the nearest, ties away from zero
+        HalfDown,   // to the nearest, ties toward zero
+        HalfEven    // to the nearest, ties to the even neighbour
+    };
+
+    BigDecimal() = default;
+
+    BigDecimal(const BigInt &, int = 0);
+
+    BigDecimal(BigInt &&, int = 0);
+
+    template<std::integral T>
+    BigDecimal(T v) : mantissa(v) {}
+
+    explicit BigDecimal(const std::string &);
+
+    const BigInt &unscaled() const;
+
+    int scale() const;
+
+    int precision() const;
+
+    std::string to_string() const;
+
+    static BigDecimal from_string(const std::string &);
+
+    BigInt to_integer(Rounding = Rounding::Down) const;
+
+    BigDecimal rescale(int, Rounding = Rounding::HalfEven) const;
+
+    BigDecimal strip_zeros() const;
+
+    BigDecimal divide(const BigDecimal &, int, Rounding = Rounding::HalfEven) const;
+
+    static void set_default_scale(int);
+
+    static int default_scale();
+
+private:
+    BigInt mantissa;    // the unscaled value
+    int exponent = 0;   // the scale, digits after the point
+
+private:
+    static int compare(const BigDecimal &, const BigDecimal &);
+
+    static int checked_scale(long long);
+
+    static void scale_up(BigInt &, long long);
+
+    static void scale_down(BigInt &, long long, Rounding);
+
+    static int compare_half(const Limbs &, const Limbs &);
+
+    static void round_quotient(BigInt &, int, bool, bool, Rounding);
+};
+
+
+#endif //BIGINT_BIGDECIMAL_H
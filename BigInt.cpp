@@ -1,630 +1,727 @@
-//
-//@brief: Implementations of BigInt class.
-//@copyright: Copyright NPU-Franklin 2020
-//@license: MIT License
-//@birth: created by NPU-Franklin 2020-3-31
-//@version: 4.0.2
-//@revision: last revised by NPU-Franklin 2020-4-4
-//
-
-#include "BigInt.h"
-#include <iostream>
-#include <vector>
-#include <string>
-#include <regex>
-#include<complex>
-
-typedef std::complex<double> comp;
-
-const double PI(acos(-1.0));
-const int N = static_cast<const int>(1e4);
-
-//binary method for multiplication.
-void bit_reverse_swap(comp *a, int n) {
-    for (int i = 1, j = n >> 1, k; i < n - 1; ++i) {
-        if (i < j) swap(a[i], a[j]);
-        for (k = n >> 1; j >= k; j -= k, k >>= 1);
-        j += k;
-    }
-}
-
-//FFT method to do multiplication.
-void FFT(comp *a, int n, int t) {
-    bit_reverse_swap(a, n);
-    for (int i = 2; i <= n; i <<= 1) {
-        comp wi(cos(2.0 * t * PI / i), sin(2.0 * t * PI / i));
-        for (int j = 0; j < n; j += i) {
-            comp w(1);
-            for (int k = j, h = i >> 1; k < j + h; ++k) {
-                comp t = w * a[k + h], u = a[k];
-                a[k] = u + t;
-                a[k + h] = u - t;
-                w *= wi;
-            }
-        }
-    }
-    if (t == -1) {
-        for (int i = 0; i < n; ++i) {
-            a[i] /= n;
-        }
-    }
-}
-
-//binary method to do multiplication.
-int trans(int x) {
-    return 1 << int(ceil(log(x) / log(2) - 1e-9));  // math.h/log() 以e为底
-}
-
-std::istream &operator>>(std::istream &in, BigInt &x) {
-//    Use operator>> to input.
-    std::string tmp;
-    in >> tmp;
-    for (char &i : tmp) {
-//        Method to deal with '-' while inputting.
-        if (i == '-') x.bigint.push_back(-1);
-        else x.bigint.push_back(i - '0');
-    }
-    return in;
-}
-
-std::ostream &operator<<(std::ostream &out, const BigInt &x) {
-//    Use operator<< to output.
-    if (x.bigint[0] == -1) {
-//        Method to deal with '-'&'.' while outputting.
-        out << "-";
-        int len = x.bigint.size();
-        for (int i = 1; i < len; i++) {
-            if (x.bigint[i] == 0.1) { out << "."; }
-            else if (x.bigint[i] < 10) { out << char(x.bigint[i] + '0'); }
-            else {
-                char copy[N];
-                int tmp = x.bigint[i];
-                int k = 0;
-                while (tmp != 0) {
-                    copy[k] = tmp % 10 + '0';
-                    tmp /= 10;
-                    k++;
-                }
-                for (int j = k; j >= 0; j--) {
-                    out << copy[j];
-                }
-            }
-        }
-    } else {
-        int len = x.bigint.size();
-        for (int i = 0; i < len; i++) {
-            if (x.bigint[i] == 0.1) { out << '.'; }
-            else if (x.bigint[i] < 10) { out << char(x.bigint[i] + '0'); }
-            else {
-                char copy[N];
-                int tmp = x.bigint[i];
-                int k = 0;
-                while (tmp != 0) {
-                    copy[k] = tmp % 10 + '0';
-                    tmp /= 10;
-                    k++;
-                }
-                for (int j = k; j >= 0; j--) {
-                    out << copy[j];
-                }
-            }
-        }
-    }
-    return out;
-}
-
-BigInt &BigInt::operator=(std::string &s) {
-//    Assignment function.
-    for (char &i : s) {
-        if (i == '-') this->bigint.push_back(-1);
-        else this->bigint.push_back(i - '0');
-    }
-}
-
-//function to compare two BigInt and return specific code for each situation.
-int BigInt::cmp(const BigInt &x) const {
-//    If caller is bigger than return 0, otherwise return 1, if is equal return 2.
-    if (this->bigint[0] != -1 && x.bigint[0] != -1) {
-        if (this->bigint.size() > x.bigint.size()) { return 0; }
-        else if (this->bigint.size() < x.bigint.size()) { return 1; }
-        else {
-            for (int i = 0; i < x.bigint.size(); i++) {
-                if (this->bigint[i] > x.bigint[i]) { return 0; }
-                else if (this->bigint[i] < x.bigint[i]) { return 1; }
-            }
-            return 2;
-        }
-    } else if (this->bigint[0] != -1 && x.bigint[0] == -1) { return 0; }
-    else if (this->bigint[0] == -1 && x.bigint[0] != -1) { return 1; }
-    else {
-        if (this->bigint.size() > x.bigint.size()) { return 1; }
-        else if (this->bigint.size() < x.bigint.size()) { return 0; }
-        else {
-            for (int i = 0; i < x.bigint.size(); i++) {
-                if (this->bigint[i] > x.bigint[i]) { return 1; }
-                else if (this->bigint[i] < x.bigint[i]) { return 0; }
-            }
-            return 2;
-        }
-    }
-}
-
-BigInt BigInt::add(const BigInt &a) const {
-//    Add two BigInt.
-    BigInt a1, b1, result;
-
-    a1 = a;
-    b1 = *this;
-
-    reverse(a1.bigint.begin(), a1.bigint.end());
-    reverse(b1.bigint.begin(), b1.bigint.end());
-
-    int tmp, len, carry = 0;
-    if (a1 < b1) {
-        int limitation = b1.size() - a1.size();
-        for (int i = 0; i < limitation; i++) { a1.bigint.push_back(0); }
-        len = b1.size();
-    } else if (a1 == b1) { len = a1.size(); }
-    else {
-        int limitation = a1.size() - b1.size();
-        for (int i = 0; i < limitation; i++) { b1.bigint.push_back(0); }
-        len = a1.size();
-    }
-//Calculate.
-    for (int i = 0; i < len; i++) {
-        tmp = static_cast<int>(a1.bigint[i] + b1.bigint[i] + carry);
-        carry = tmp / 10;
-        tmp %= 10;
-        result.bigint.push_back(tmp);
-    }
-    if (carry != 0) { result.bigint.push_back(carry); }
-
-    reverse(result.bigint.begin(), result.bigint.end());
-
-    return result;
-}
-
-BigInt BigInt::minus(const BigInt &b) const {
-    BigInt a1, b1, result;
-    enum theSign {
-        pl, mi
-    };
-    theSign sign;
-    if (*this > b) {
-        a1 = *this;
-        b1 = b;
-        sign = pl;
-    } else if (*this < b) {
-        a1 = b;
-        b1 = *this;
-        sign = mi;
-    } else {
-        result.bigint.push_back(0);
-        return result;
-    }
-
-    reverse(a1.bigint.begin(), a1.bigint.end());
-    reverse(b1.bigint.begin(), b1.bigint.end());
-
-    unsigned long long limitation = a1.bigint.size() - b1.bigint.size();
-    for (int i = 0; i < limitation; i++) { b1.bigint.push_back(0); }
-
-    int tmp, borrow = 0, len = a1.size();
-    for (int i = 0; i < len; i++) {
-        tmp = static_cast<int>(a1.bigint[i] - b1.bigint[i] + borrow);
-        if (tmp < 0) {
-            tmp += 10;
-            borrow = -1;
-        } else { borrow = 0; }
-        result.bigint.push_back(tmp);
-    }
-
-    limitation = result.bigint.size();
-    int flag = 0;
-    for (unsigned long long i = limitation - 1; i >= 0; i--) {
-        if (result.bigint[i] == 0) { flag++; }
-        else break;
-    }
-    for (int i = 0; i < flag; i++) {
-        result.bigint.pop_back();
-    }
-    reverse(result.bigint.begin(), result.bigint.end());
-
-    if (sign == mi) { result.bigint.insert(result.bigint.begin(), -1); }
-
-}
-
-//multiplication based on FFT.
-BigInt BigInt::multiply(const BigInt &x) const {
-    BigInt result;
-    int n, m, l;
-    n = static_cast<int>(this->bigint.size());
-    m = static_cast<int>(x.bigint.size());
-    l = trans(n + m - 1);
-    comp a[N], b[N];
-    int ans[N];
-    for (int i = 0; i < n; ++i) a[i] = comp(this->bigint[n - 1 - i]);
-    for (int i = n; i < l; ++i) a[i] = comp(0);
-    for (int i = 0; i < m; ++i) b[i] = comp(x.bigint[m - 1 - i]);
-    for (int i = m; i < l; ++i) b[i] = comp(0);
-
-    FFT(a, l, 1);
-    FFT(b, l, 1);
-    for (int i = 0; i < l; ++i) a[i] *= b[i];
-    FFT(a, l, -1);
-    for (int i = 0; i < l; ++i) ans[i] = (int) (a[i].real() + 0.5);
-    ans[l] = 0;
-    for (int i = 0; i < l; ++i) {
-        ans[i + 1] += ans[i] / 10;
-        ans[i] %= 10;
-    }
-    int p = l;
-    for (; p && !ans[p]; --p);
-    for (; ~p; result.bigint.push_back(ans[p--]));
-
-    return result;
-}
-
-BigInt BigInt::divide(const BigInt &x, int i) const {
-//    Division method, which default reserved digits is 0.
-    BigInt a1, b1, result;
-    if (i < 0) { throw "Invalid reservation digits."; }
-    if (x.bigint[0] == 0 && x.size() == 1) { throw "Can't divide by zero."; }
-    if (*this == x) {
-        result.bigint.push_back(1);
-        if (i == 0) { return result; }
-        else {
-            result.bigint.push_back(0.1);
-            for (int j = 0; j < i; j++) { result.bigint.push_back(0); }
-        }
-    } else if (*this > x) {
-        a1 = *this;
-        b1 = x;
-
-        double carry = b1.bigint[b1.size() - 1];
-        unsigned long long limitation = a1.size() - b1.size();
-        for (unsigned long long i = 0; i < limitation; i++) { b1.bigint.push_back(0); }
-
-        int tmp = 0, len = b1.bigint.size();
-        for (int i = 0; i < limitation + 1; i++) {
-            while (a1 >= b1) {
-                a1 = a1 - b1;
-                tmp++;
-            }
-            result.bigint.push_back(tmp);
-            b1.bigint.pop_back();
-            tmp = 0;
-        }
-
-        int flag = 0;
-        for (unsigned long long j = 0; j < len; j++) {
-            if (result.bigint[j] == 0) { flag++; }
-            else break;
-        }
-        reverse(result.bigint.begin(), result.bigint.end());
-        for (int j = 0; j < flag; j++) { result.bigint.pop_back(); }
-        reverse(result.bigint.begin(), result.bigint.end());
-
-        if (i != 0) {
-            result.bigint.push_back(0.1);
-            if (a1.bigint[0] == 0 && a1.bigint.size() == 1) {
-                for (int j = 0; j < i; j++) {
-                    result.bigint.push_back(0);
-                }
-            } else {
-                for (int j = 0; j < i; j++) { a1.bigint.push_back(0); }
-                b1.bigint.push_back(carry);
-                for (int j = 0; j < i - 1; j++) { b1.bigint.push_back(0); }
-
-                for (int j = 0; j < i; j++) {
-                    if (a1 < b1) { tmp = 0; }
-                    else {
-                        while (a1 >= b1) {
-                            a1 = a1 - b1;
-                            tmp++;
-                        }
-                    }
-
-                    result.bigint.push_back(tmp);
-                    b1.bigint.pop_back();
-                    tmp = 0;
-                }
-            }
-        }
-    } else {
-        result.bigint.push_back(0);
-        if (i != 0) {
-            a1 = *this;
-            b1 = x;
-
-            result.bigint.push_back(0.1);
-            for (int j = 0; j < i; j++) { a1.bigint.push_back(0); }
-            for (int j = 0; j < i - 1; j++) { b1.bigint.push_back(0); }
-
-            int tmp = 0;
-            for (int j = 0; j < i; j++) {
-                if (a1 < b1) { tmp = 0; }
-                else {
-                    while (a1 >= b1) {
-                        a1 = a1 - b1;
-                        tmp++;
-                    }
-                }
-                result.bigint.push_back(tmp);
-                b1.bigint.pop_back();
-                tmp = 0;
-            }
-        }
-    }
-
-    return result;
-}
-
-//modulo function
-BigInt BigInt::mod(const BigInt &a) const {
-    BigInt a1, b1, result;
-    a1 = *this;
-    b1 = a;
-    result = a1.divide(b1, 0);
-    result = b1 * result;
-    result = a1 - result;
-
-    return result;
-}
-
-BigInt operator+(BigInt &a, BigInt &b) {
-//    Reload operator '+'
-    BigInt result;
-
-    std::vector<double>::iterator it;
-    if (a.bigint[0] == -1 && b.bigint[0] == -1) {
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-
-        result = a.add(b);
-        result.bigint.insert(result.bigint.begin(), -1);
-    } else if (a.bigint[0] != -1 && b.bigint[0] != -1) {
-        result = a.add(b);
-    } else if (a.bigint[0] == -1 && b.bigint[0] != -1) {
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-        result = b.minus(a);
-    } else {
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-        result = a.minus(b);
-    }
-
-    return result;
-}
-
-BigInt operator-(BigInt &a, BigInt &b) {
-//    Reload operator ‘-’
-    BigInt result;
-
-    std::vector<double>::iterator it;
-    if (a.bigint[0] == -1 && b.bigint[0] == -1) {
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-
-        result = b.minus(a);
-    } else if (a.bigint[0] == -1 && b.bigint[0] != -1) {
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-
-        result = a.add(b);
-        result.bigint.insert(result.bigint.begin(), -1);
-    } else if (a.bigint[0] != -1 && b.bigint[0] == -1) {
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-
-        result = a.add(b);
-    } else { result = a.minus(b); }
-
-    return result;
-}
-
-BigInt operator*(BigInt &a, BigInt &b) {
-//    Reload operator '*'
-    BigInt result;
-
-    std::vector<double>::iterator it;
-    if (a.bigint[0] == -1 && b.bigint[0] == -1) {
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-
-        result = a.multiply(b);
-    } else if (a.bigint[0] == -1 && b.bigint[0] != -1) {
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-
-        result = a.multiply(b);
-        it = result.bigint.begin();
-        result.bigint.insert(it, -1);
-    } else if (a.bigint[0] != -1 && b.bigint[0] == -1) {
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-
-        result = a.multiply(b);
-        it = result.bigint.begin();
-        result.bigint.insert(it, -1);
-    } else { result = a.multiply(b); }
-
-    return result;
-}
-
-BigInt operator/(BigInt &a, BigInt &b) {
-//    Reload operator '/'
-    BigInt result;
-    if (a.bigint[0] == -1 && b.bigint[0] == -1) {
-        std::vector<double>::iterator it;
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-
-        result = a.divide(b);
-    } else if (a.bigint[0] == -1 && b.bigint[0] != -1) {
-        std::vector<double>::iterator it;
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-
-        result = a.divide(b);
-        it = result.bigint.begin();
-        result.bigint.insert(it, -1);
-    } else if (a.bigint[0] != -1 && b.bigint[0] == -1) {
-        std::vector<double>::iterator it;
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-
-        result = a.divide(b);
-        it = result.bigint.begin();
-        result.bigint.insert(it, -1);
-    } else {
-        result = a.divide(b);
-    }
-
-    return result;
-}
-
-BigInt operator%(BigInt &a, BigInt &b) {
-//    Reload operator '%'
-    BigInt result;
-    if (a.bigint[0] == -1 && b.bigint[0] == -1) {
-        std::vector<double>::iterator it;
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-
-        result = a.mod(b);
-        it = result.bigint.begin();
-        result.bigint.insert(it, -1);
-    } else if (a.bigint[0] == -1 && b.bigint[0] != -1) {
-        std::vector<double>::iterator it;
-        it = a.bigint.begin();
-        a.bigint.erase(it);
-
-        result = a.mod(b);
-    } else if (a.bigint[0] != -1 && b.bigint[0] == -1) {
-        std::vector<double>::iterator it;
-        it = b.bigint.begin();
-        b.bigint.erase(it);
-
-        result = a.mod(b);
-        it = result.bigint.begin();
-        result.bigint.insert(it, -1);
-    } else {
-        result = a.mod(b);
-    }
-
-    return result;
-}
-
-BigInt operator+=(BigInt &a, BigInt &b) {
-//    Reload operator '+='
-    a = a + b;
-    return a;
-}
-
-BigInt operator-=(BigInt &a, BigInt &b) {
-//    Reload operator '-='
-    a = a - b;
-    return a;
-}
-
-BigInt operator*=(BigInt &a, BigInt &b) {
-//    Reload operator '*='
-    a = a * b;
-    return a;
-}
-
-BigInt operator/=(BigInt &a, BigInt &b) {
-//    Reload operator '/='
-    a = a / b;
-    return a;
-}
-
-BigInt operator%=(BigInt &a, BigInt &b) {
-//    Reload operator '%='
-    a = a % b;
-    return a;
-}
-
-BigInt pow(BigInt &a, int n) {
-//    ordinary method to calculate power.
-    BigInt result;
-    result.bigint.push_back(1);
-    for (int i = 0; i < n; i++) {
-        result = result * a;
-    }
-
-    return result;
-}
-
-BigInt &BigInt::operator++(int) {
-    BigInt tmp;
-    tmp.bigint.push_back(1);
-    *this = this->add(tmp);
-    return *this;
-}
-
-BigInt &BigInt::operator++() {
-    BigInt tmp;
-    tmp.bigint.push_back(1);
-    *this = this->add(tmp);
-    return *this;
-}
-
-BigInt &BigInt::operator--(int) {
-    BigInt tmp;
-    tmp.bigint.push_back(-1);
-    *this = this->add(tmp);
-    return *this;
-}
-
-BigInt &BigInt::operator--() {
-    BigInt tmp;
-    tmp.bigint.push_back(-1);
-    *this = this->add(tmp);
-    return *this;
-}
-
-bool operator==(const BigInt &x, const BigInt &y) {
-    return x.cmp(y) == 2;
-}
-
-bool operator!=(const BigInt &x, const BigInt &y) {
-    return x.cmp(y) != 2;
-}
-
-bool operator<(const BigInt &x, const BigInt &y) {
-    return x.cmp(y) == 1;
-}
-
-bool operator>(const BigInt &x, const BigInt &y) {
-    return x.cmp(y) == 0;
-}
-
-bool operator<=(const BigInt &x, const BigInt &y) {
-    return x.cmp(y) == 1 || x.cmp(y) == 2;
-}
-
-bool operator>=(const BigInt &x, const BigInt &y) {
-    return x.cmp(y) == 0 || x.cmp(y) == 2;
-}
-
-inline int BigInt::size() const {
-    return static_cast<int>(this->bigint.size());
-}
\ No newline at end of file
+//
+//@brief: Implementations of BigInt class.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2020-3-31
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "BigInt.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include "Multiply.h"
+#include "Divide.h"
+#include "Kernel.h"
+#include "Radix.h"
+#include "Stats.h"
+
+typedef BigInt::limb limb;
+typedef unsigned __int128 dlimb;
+
+const int DEC_DIGITS = 19;                          // digits of the largest power of ten fitting in a limb
+const limb LOG10_2_HIGH = 0x4d104d427de7fbcc;       // log10 2 as a 128-bit fraction
+const limb LOG10_2_LOW = 0x47c4acd605be48bc;
+
+//strip leading zero limbs so that zero is an empty vector.
+static void trim(Limbs &a) {
+    a.resize(kernel::normalized_size(a.data(), a.size()));
+}
+
+//compare two magnitudes, return -1, 0 or 1.
+static int cmp_limbs(const Limbs &a, const Limbs &b) {
+    if (a.size() != b.size()) { return a.size() < b.size() ? -1 : 1; }
+    return kernel::cmp_n(a.data(), b.data(), a.size());
+}
+
+//a <<= s bits.
+static void shl_bits(Limbs &a, size_t s) {
+    if (a.empty() || s == 0) { return; }
+    size_t whole = s / 64;
+    unsigned bits = s % 64;
+    if (bits != 0) {
+        limb high = 0;
+        for (limb &x : a) {
+            limb next = x >> (64 - bits);
+            x = (x << bits) | high;
+            high = next;
+        }
+        if (high != 0) { a.push_back(high); }
+    }
+    a.insert(a.begin(), whole, 0);
+}
+
+//a >>= s bits.
+static void shr_bits(Limbs &a, size_t s) {
+    size_t whole = s / 64;
+    unsigned bits = s % 64;
+    if (whole >= a.size()) {
+        a.clear();
+        return;
+    }
+    a.erase(a.begin(), a.begin() + whole);
+    if (bits != 0) {
+        for (size_t i = 0; i < a.size(); i++) {
+            a[i] = (a[i] >> bits) | (i + 1 < a.size() ? a[i + 1] << (64 - bits) : 0);
+        }
+    }
+    trim(a);
+}
+
+//a *= m in place.
+static void mul_limb(Limbs &a, limb m) {
+    limb carry = kernel::mul_1(a.data(), a.data(), a.size(), m);
+    if (carry != 0) { a.push_back(carry); }
+}
+
+//10^k for k > 0, as 5^k squared up at the limb level and shifted by k, so that no operation is counted.
+static Limbs power_of_ten(size_t k) {
+    Limbs p(1, 1), t;
+    for (int i = 63 - __builtin_clzll(k); i >= 0; i--) {
+        t.resize(2 * p.size());
+        square_limbs(t.data(), p.data(), p.size());
+        trim(t);
+        p.swap(t);
+        if ((k >> i) & 1) { mul_limb(p, 5); }
+    }
+    shl_bits(p, k);
+    return p;
+}
+
+std::istream &operator>>(std::istream &in, BigInt &x) {
+//    Use operator>> to input.
+    std::string tmp;
+    if (in >> tmp) { x = tmp; }
+    return in;
+}
+
+std::ostream &operator<<(std::ostream &out, const BigInt &x) {
+//    Use operator<< to output.
+    out << x.to_string();
+    return out;
+}
+
+BigInt::BigInt(const std::string &s) {
+    *this = s;
+}
+
+BigInt &BigInt::operator=(const std::string &s) {
+//    Assignment function.
+    *this = from_string(s);
+    return *this;
+}
+
+std::string BigInt::to_string(int base) const {
+//    Digits in the given base with a leading '-' for negative numbers.
+    BIGINT_STAT_OP(Print, this->limbs.size());
+    std::string s = limbs_to_string(this->limbs, base);
+    if (this->negative) { s.insert(0, 1, '-'); }
+    return s;
+}
+
+BigInt BigInt::from_string(const std::string &s, int base) {
+//    An optional sign followed by digits in the given base.
+    BIGINT_STAT_OP(Parse, s.size() / DEC_DIGITS);
+    BigInt result;
+    size_t pos = 0;
+    bool neg = false;
+    if (pos < s.size() && (s[pos] == '-' || s[pos] == '+')) { neg = s[pos++] == '-'; }
+    string_to_limbs(s.data() + pos, s.size() - pos, base, result.limbs);
+    result.negative = neg && !result.limbs.empty();
+    return result;
+}
+
+//drop leading zero limbs and clear the sign of zero.
+void BigInt::normalize() {
+    trim(this->limbs);
+    if (this->limbs.empty()) { this->negative = false; }
+}
+
+//function to compare two BigInt and return specific code for each situation.
+int BigInt::cmp(const BigInt &x) const {
+//    If caller is bigger than return 0, otherwise return 1, if is equal return 2.
+    if (this->negative != x.negative) { return this->negative ? 1 : 0; }
+    int c = cmp_limbs(this->limbs, x.limbs);
+    if (c == 0) { return 2; }
+    if (this->negative) { c = -c; }
+    return c > 0 ? 0 : 1;
+}
+
+//the same codes as above against the built-in integer (-1)^mneg * m.
+int BigInt::cmp_small(limb m, bool mneg) const {
+    BIGINT_STAT_OP(Compare, this->limbs.size());
+    if (m == 0) { mneg = false; }
+    if (this->negative != mneg) { return this->negative ? 1 : 0; }
+    if (this->limbs.size() <= 1) {
+        const limb a = this->limbs.empty() ? 0 : this->limbs[0];
+        if (a == m) { return 2; }
+        return (a > m) != this->negative ? 0 : 1;
+    }
+    return this->negative ? 1 : 0;
+}
+
+BigInt BigInt::add(const BigInt &a) const {
+//    Add the magnitudes of two BigInt.
+    BigInt result;
+    const Limbs &x = this->limbs.size() >= a.limbs.size() ? this->limbs : a.limbs;
+    const Limbs &y = this->limbs.size() >= a.limbs.size() ? a.limbs : this->limbs;
+
+    result.limbs.resize(x.size() + 1);
+    BIGINT_STAT_ALLOC(result.limbs.size() * sizeof(limb));
+//Calculate.
+    result.limbs[x.size()] = kernel::add(result.limbs.data(), x.data(), x.size(), y.data(), y.size());
+    result.normalize();
+
+    return result;
+}
+
+BigInt BigInt::minus(const BigInt &b) const {
+//    Subtract the magnitude of b from the magnitude of the caller.
+    BigInt result;
+    int c = cmp_limbs(this->limbs, b.limbs);
+    if (c == 0) { return result; }
+    BIGINT_STAT_ALLOC(std::max(this->limbs.size(), b.limbs.size()) * sizeof(limb));
+    const Limbs &x = c > 0 ? this->limbs : b.limbs;
+    const Limbs &y = c > 0 ? b.limbs : this->limbs;
+    result.limbs.resize(x.size());
+    kernel::sub(result.limbs.data(), x.data(), x.size(), y.data(), y.size());
+    result.negative = c < 0;
+    result.normalize();
+
+    return result;
+}
+
+BigInt BigInt::square() const {
+//    this * this through the squaring paths of the dispatcher.
+    BIGINT_STAT_OP(Square, this->limbs.size());
+    BigInt result;
+    if (this->limbs.empty()) { return result; }
+    result.limbs.resize(2 * this->limbs.size());
+    BIGINT_STAT_ALLOC(result.limbs.size() * sizeof(limb));
+    square_limbs(result.limbs.data(), this->limbs.data(), this->limbs.size());
+    result.normalize();
+
+    return result;
+}
+
+//multiplication through the size-tiered dispatcher.
+BigInt BigInt::multiply(const BigInt &x) const {
+//    Multiply the magnitudes of two BigInt.
+    BigInt result;
+    if (this->limbs.empty() || x.limbs.empty()) { return result; }
+    result.limbs.resize(this->limbs.size() + x.limbs.size());
+    BIGINT_STAT_ALLOC(result.limbs.size() * sizeof(limb));
+    multiply_limbs(result.limbs.data(), this->limbs.data(), this->limbs.size(), x.limbs.data(), x.limbs.size());
+    result.normalize();
+
+    return result;
+}
+
+BigDecimal BigInt::divide(const BigInt &x, int i) const {
+//    Division method, which default reserved digits is 0. The digits past the reserved ones are dropped.
+    if (i < 0) { throw "Invalid reservation digits."; }
+    return BigDecimal(*this).divide(x, i, BigDecimal::Rounding::Down);
+}
+
+//quotient and remainder from a single division.
+void BigInt::divmod(const BigInt &x, BigInt &q, BigInt &r) const {
+//    The quotient is truncated and the remainder takes the sign of the dividend, just like int type.
+    BIGINT_STAT_OP(Div, std::max(this->limbs.size(), x.limbs.size()));
+    if (x.limbs.empty()) { throw "Can't divide by zero."; }
+    bool qneg = this->negative != x.negative, rneg = this->negative;
+    Limbs quotient, remainder;
+    divide_limbs(this->limbs, x.limbs, quotient, remainder);
+    BIGINT_STAT_ALLOC((quotient.capacity() + remainder.capacity()) * sizeof(limb));
+    q.limbs.swap(quotient);
+    q.negative = qneg;
+    q.normalize();
+    r.limbs.swap(remainder);
+    r.negative = rneg;
+    r.normalize();
+}
+
+std::pair<BigInt, BigInt> BigInt::divmod(const BigInt &x) const {
+    std::pair<BigInt, BigInt> result;
+    this->divmod(x, result.first, result.second);
+    return result;
+}
+
+BigInt operator+(const BigInt &a, const BigInt &b) {
+//    Reload operator '+'
+    BIGINT_STAT_OP(Add, std::max(a.limbs.size(), b.limbs.size()));
+    BigInt result;
+    if (a.negative == b.negative) {
+        result = a.add(b);
+        result.negative = a.negative;
+    } else if (a.negative) {
+        result = b.minus(a);
+    } else {
+        result = a.minus(b);
+    }
+    result.normalize();
+
+    return result;
+}
+
+BigInt operator+(BigInt &&a, const BigInt &b) {
+//    The temporary on the left lends its storage to the result.
+    BIGINT_STAT_OP(Add, std::max(a.limbs.size(), b.limbs.size()));
+    a.accumulate(b, false);
+    return std::move(a);
+}
+
+BigInt operator+(const BigInt &a, BigInt &&b) {
+    BIGINT_STAT_OP(Add, std::max(a.limbs.size(), b.limbs.size()));
+    b.accumulate(a, false);
+    return std::move(b);
+}
+
+BigInt operator+(BigInt &&a, BigInt &&b) {
+    BIGINT_STAT_OP(Add, std::max(a.limbs.size(), b.limbs.size()));
+    a.accumulate(b, false);
+    return std::move(a);
+}
+
+BigInt operator-(const BigInt &a, const BigInt &b) {
+//    Reload operator ‘-’
+    BIGINT_STAT_OP(Sub, std::max(a.limbs.size(), b.limbs.size()));
+    BigInt result;
+    if (a.negative && b.negative) {
+        result = b.minus(a);
+    } else if (a.negative && !b.negative) {
+        result = a.add(b);
+        result.negative = true;
+    } else if (!a.negative && b.negative) {
+        result = a.add(b);
+    } else { result = a.minus(b); }
+    result.normalize();
+
+    return result;
+}
+
+BigInt operator-(BigInt &&a, const BigInt &b) {
+    BIGINT_STAT_OP(Sub, std::max(a.limbs.size(), b.limbs.size()));
+    a.accumulate(b, true);
+    return std::move(a);
+}
+
+BigInt operator-(const BigInt &a, BigInt &&b) {
+//    a - b = -(b - a).
+    BIGINT_STAT_OP(Sub, std::max(a.limbs.size(), b.limbs.size()));
+    b.accumulate(a, true);
+    b.negative = !b.negative;
+    b.normalize();
+    return std::move(b);
+}
+
+BigInt operator-(BigInt &&a, BigInt &&b) {
+    BIGINT_STAT_OP(Sub, std::max(a.limbs.size(), b.limbs.size()));
+    a.accumulate(b, true);
+    return std::move(a);
+}
+
+BigInt operator*(const BigInt &a, const BigInt &b) {
+//    Reload operator '*'
+    BIGINT_STAT_OP(Mul, std::max(a.limbs.size(), b.limbs.size()));
+    BigInt result = a.multiply(b);
+    result.negative = a.negative != b.negative;
+    result.normalize();
+
+    return result;
+}
+
+BigInt operator*(BigInt &&a, const BigInt &b) {
+    BIGINT_STAT_OP(Mul, std::max(a.limbs.size(), b.limbs.size()));
+    a *= b;
+    return std::move(a);
+}
+
+BigInt operator/(const BigInt &a, const BigInt &b) {
+//    Reload operator '/'
+    BIGINT_STAT_OP(Div, std::max(a.limbs.size(), b.limbs.size()));
+    BigInt q, r;
+    a.divmod(b, q, r);
+    return q;
+}
+
+BigInt operator%(const BigInt &a, const BigInt &b) {
+//    Reload operator '%'
+    BIGINT_STAT_OP(Mod, std::max(a.limbs.size(), b.limbs.size()));
+    BigInt q, r;
+    a.divmod(b, q, r);
+    return r;
+}
+
+BigInt &operator+=(BigInt &a, const BigInt &b) {
+//    Reload operator '+=', adding in place.
+    BIGINT_STAT_OP(Add, std::max(a.limbs.size(), b.limbs.size()));
+    a.accumulate(b, false);
+    return a;
+}
+
+BigInt &operator-=(BigInt &a, const BigInt &b) {
+//    Reload operator '-=', subtracting in place.
+    BIGINT_STAT_OP(Sub, std::max(a.limbs.size(), b.limbs.size()));
+    a.accumulate(b, true);
+    return a;
+}
+
+BigInt &operator*=(BigInt &a, const BigInt &b) {
+//    Reload operator '*=', the product is built in scratch and copied back into the storage of a,
+//    so repeated products of similar size do not allocate. Scratch frames nest, so a pool task
+//    that runs on this thread while the product waits for its halves gets a buffer of its own.
+    BIGINT_STAT_OP(Mul, std::max(a.limbs.size(), b.limbs.size()));
+    bool negative = a.negative != b.negative;
+    if (a.limbs.empty() || b.limbs.empty()) {
+        a.limbs.clear();
+    } else {
+        const size_t n = a.limbs.size() + b.limbs.size();
+        memory::Scratch scratch;
+        limb *product = scratch.take<limb>(n);
+        multiply_limbs(product, a.limbs.data(), a.limbs.size(), b.limbs.data(), b.limbs.size());
+        a.limbs.assign(product, product + n);
+    }
+    a.negative = negative;
+    a.normalize();
+    return a;
+}
+
+BigInt &operator/=(BigInt &a, const BigInt &b) {
+//    Reload operator '/='
+    BIGINT_STAT_OP(Div, std::max(a.limbs.size(), b.limbs.size()));
+    BigInt r;
+    a.divmod(b, a, r);
+    return a;
+}
+
+BigInt &operator%=(BigInt &a, const BigInt &b) {
+//    Reload operator '%='
+    BIGINT_STAT_OP(Mod, std::max(a.limbs.size(), b.limbs.size()));
+    BigInt q;
+    a.divmod(b, q, a);
+    return a;
+}
+
+BigInt pow(const BigInt &a, int n) {
+//    Power with a machine exponent, see below.
+    BIGINT_STAT_OP(Pow, a.limbs.size());
+    if (n < 0) { throw "Invalid exponent."; }
+    BigInt e;
+    if (n > 0) { e.limbs.push_back(static_cast<limb>(n)); }
+    return pow(a, e);
+}
+
+BigInt pow(const BigInt &a, const BigInt &e) {
+//    Left-to-right sliding window exponentiation. The factors of two of the base are taken out and
+//    applied as one shift at the end, so powers of 2 and 10 cost a shift and a power of 1 and 5.
+    BIGINT_STAT_OP(Pow, a.limbs.size());
+    if (e.negative) { throw "Invalid exponent."; }
+    BigInt result;
+    result.limbs.push_back(1);
+    if (e.limbs.empty()) { return result; }
+    if (a.limbs.empty()) { return BigInt(); }
+    const bool negative = a.negative && (e.limbs[0] & 1) != 0;
+    if (a.limbs.size() == 1 && a.limbs[0] == 1) {
+        result.negative = negative;
+        return result;
+    }
+    if (e.limbs.size() > 1) { throw "Exponent too large."; }
+    const limb n = e.limbs[0];
+
+    size_t zeros = 0;
+    while (a.limbs[zeros] == 0) { zeros++; }
+    zeros = zeros * 64 + __builtin_ctzll(a.limbs[zeros]);
+    size_t shift;
+    if (__builtin_mul_overflow(zeros, n, &shift)) { throw "Exponent too large."; }
+    BigInt odd;
+    odd.limbs = a.limbs;
+    shr_bits(odd.limbs, zeros);
+
+    if (odd.limbs.size() > 1 || odd.limbs[0] != 1) {
+//        Odd powers x, x^3, ..., x^(2^k - 1) of the window size k picked from the exponent length.
+        const int bits = 64 - __builtin_clzll(n);
+        const int k = bits <= 8 ? 1 : bits <= 24 ? 2 : bits <= 48 ? 3 : 4;
+        std::vector<BigInt> table(size_t(1) << (k - 1));
+        table[0] = odd;
+        if (k > 1) {
+            BigInt x2 = odd.square();
+            for (size_t i = 1; i < table.size(); i++) { table[i] = table[i - 1] * x2; }
+        }
+
+        bool started = false;
+        for (int i = bits - 1; i >= 0;) {
+            if (((n >> i) & 1) == 0) {
+                result *= result;
+                i--;
+                continue;
+            }
+//            The longest window of at most k bits starting at bit i and ending with a one.
+            int j = std::max(i - k + 1, 0);
+            while (((n >> j) & 1) == 0) { j++; }
+            limb w = (n >> j) & ((limb(1) << (i - j + 1)) - 1);
+            if (started) {
+                for (int l = j; l <= i; l++) { result *= result; }
+                result *= table[w >> 1];
+            } else {
+                result = table[w >> 1];
+                started = true;
+            }
+            i = j - 1;
+        }
+    }
+
+    shl_bits(result.limbs, shift);
+    result.negative = negative;
+    result.normalize();
+
+    return result;
+}
+
+//this += x, or this -= x when subtract is set, reusing the storage of the caller.
+void BigInt::accumulate(const BigInt &x, bool subtract) {
+    this->accumulate(x.limbs.data(), x.limbs.size(), x.negative != subtract);
+}
+
+//this += (-1)^xneg * x[0..m), x may alias the storage of the caller.
+void BigInt::accumulate(const limb *x, size_t m, bool xneg) {
+    size_t n = this->limbs.size();
+    while (m > 0 && x[m - 1] == 0) { m--; }
+    if (m == 0) { return; }
+    if (this->negative == xneg || n == 0) {
+        if (n < m) { this->limbs.resize(m, 0); }
+        limb carry = kernel::add(this->limbs.data(), this->limbs.data(), this->limbs.size(), x, m);
+        if (carry != 0) { this->limbs.push_back(carry); }
+        this->negative = xneg;
+    } else {
+        int c = n != m ? (n < m ? -1 : 1) : kernel::cmp_n(this->limbs.data(), x, n);
+        if (c >= 0) {
+            kernel::sub(this->limbs.data(), this->limbs.data(), n, x, m);
+        } else {
+            this->limbs.resize(m, 0);
+            kernel::sub(this->limbs.data(), x, m, this->limbs.data(), n);
+            this->negative = xneg;
+        }
+    }
+    this->normalize();
+}
+
+//this += (-1)^xneg * x for a single limb x, the carry or borrow only runs as far as it has to.
+void BigInt::accumulate_small(limb x, bool xneg) {
+    Limbs &a = this->limbs;
+    if (x == 0) { return; }
+    if (a.empty()) {
+        a.push_back(x);
+        this->negative = xneg;
+    } else if (this->negative == xneg) {
+        size_t i = 0;
+        for (; i < a.size() && x != 0; i++) {
+            a[i] += x;
+            x = a[i] < x;
+        }
+        if (x != 0) { a.push_back(x); }
+    } else if (a.size() == 1 && a[0] < x) {
+        a[0] = x - a[0];
+        this->negative = xneg;
+    } else {
+        for (size_t i = 0; x != 0; i++) {
+            limb old = a[i];
+            a[i] = old - x;
+            x = old < x;
+        }
+        this->normalize();
+    }
+}
+
+BigInt &BigInt::assign_small(limb m, bool mneg) {
+//    The limb goes into the storage already there, inline or not.
+    this->limbs.clear();
+    if (m != 0) { this->limbs.push_back(m); }
+    this->negative = mneg && m != 0;
+    return *this;
+}
+
+BigInt &BigInt::add_small(limb m, bool mneg) {
+    BIGINT_STAT_OP(Add, this->limbs.size());
+    this->accumulate_small(m, mneg);
+    return *this;
+}
+
+BigInt &BigInt::sub_small(limb m, bool mneg) {
+    BIGINT_STAT_OP(Sub, this->limbs.size());
+    this->accumulate_small(m, !mneg);
+    return *this;
+}
+
+//this *= m in one pass, the sign is kept.
+BigInt &BigInt::mul_small(limb m) {
+    BIGINT_STAT_OP(Mul, this->limbs.size());
+    if (m == 0) { this->limbs.clear(); }
+    else { mul_limb(this->limbs, m); }
+    this->normalize();
+    return *this;
+}
+
+//this /= d truncated, return |this| % d, the sign is kept.
+limb BigInt::divmod_small(limb d) {
+    BIGINT_STAT_OP(Div, this->limbs.size());
+    if (d == 0) { throw "Can't divide by zero."; }
+    limb r = kernel::divmod_1(this->limbs.data(), this->limbs.data(), this->limbs.size(), d);
+    this->normalize();
+    return r;
+}
+
+//|this| % d, read only.
+limb BigInt::mod_small(limb d) const {
+    BIGINT_STAT_OP(Mod, this->limbs.size());
+    if (d == 0) { throw "Can't divide by zero."; }
+    return kernel::mod_1(this->limbs.data(), this->limbs.size(), d);
+}
+
+//sum of signed terms and products in one pass per sign, see BigIntExpr.h.
+void BigInt::evaluate(BigInt &dst, const Term *terms, size_t n) {
+//    If dst only shows up as one positive plain term it is the starting value and the rest is
+//    accumulated in place, if it shows up anywhere else the result is built aside.
+    size_t self = n, aliases = 0, longest = 0;
+    for (size_t i = 0; i < n; i++) {
+        longest = std::max({longest, terms[i].x->limbs.size(), terms[i].y ? terms[i].y->limbs.size() : 0});
+        if (terms[i].x == &dst || terms[i].y == &dst) {
+            aliases++;
+            if (!terms[i].y && !terms[i].negative) { self = i; }
+        }
+    }
+    BIGINT_STAT_OP(Expression, longest);
+    bool in_place = aliases == 1 && self < n;
+    if (!in_place) { self = n; }
+    BigInt aside;
+    BigInt &out = aliases == 0 || in_place ? dst : aside;
+    if (!in_place) {
+        out.limbs.clear();
+        out.negative = false;
+    }
+
+//    Plain terms: add up the magnitudes of each sign group column by column with a single carry chain.
+    for (int sign = 0; sign < 2; sign++) {
+        size_t len = 0, count = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (i != self && !terms[i].y && (terms[i].negative != terms[i].x->negative) == (sign == 1)) {
+                len = std::max(len, terms[i].x->limbs.size());
+                count++;
+            }
+        }
+        if (count == 0) { continue; }
+        memory::Scratch scratch;
+        limb *sum = scratch.take<limb>(len + 2);
+        dlimb carry = 0;
+        for (size_t j = 0; j < len; j++) {
+            dlimb acc = carry;
+            for (size_t i = 0; i < n; i++) {
+                const Term &t = terms[i];
+                if (i != self && !t.y && (t.negative != t.x->negative) == (sign == 1) && j < t.x->limbs.size()) {
+                    acc += t.x->limbs[j];
+                }
+            }
+            sum[j] = static_cast<limb>(acc);
+            carry = acc >> 64;
+        }
+        sum[len] = static_cast<limb>(carry);
+        sum[len + 1] = static_cast<limb>(carry >> 64);
+        out.accumulate(sum, len + 2, sign == 1);
+    }
+
+//    Products: a * b + c is folded into the destination without a BigInt for a * b, and x * x
+//    reaches the squaring paths of the multiplier.
+    for (size_t i = 0; i < n; i++) {
+        const Term &t = terms[i];
+        if (!t.y) { continue; }
+        const Limbs &x = t.x->limbs, &y = t.y->limbs;
+        if (x.empty() || y.empty()) { continue; }
+        bool negative = t.negative != (t.x->negative != t.y->negative);
+        if (out.limbs.empty()) {
+            out.limbs.resize(x.size() + y.size());
+            multiply_limbs(out.limbs.data(), x.data(), x.size(), y.data(), y.size());
+            out.negative = negative;
+            out.normalize();
+        } else {
+            memory::Scratch scratch;
+            limb *product = scratch.take<limb>(x.size() + y.size());
+            multiply_limbs(product, x.data(), x.size(), y.data(), y.size());
+            out.accumulate(product, x.size() + y.size(), negative);
+        }
+    }
+    out.normalize();
+    if (&out != &dst) { dst = std::move(out); }
+}
+
+BigInt BigInt::operator++(int) {
+    BIGINT_STAT_OP(Add, this->limbs.size());
+    BigInt old = *this;
+    ++*this;
+    return old;
+}
+
+BigInt &BigInt::operator++() {
+    BIGINT_STAT_OP(Add, this->limbs.size());
+    this->accumulate_small(1, false);
+    return *this;
+}
+
+BigInt BigInt::operator--(int) {
+    BIGINT_STAT_OP(Sub, this->limbs.size());
+    BigInt old = *this;
+    --*this;
+    return old;
+}
+
+BigInt &BigInt::operator--() {
+    BIGINT_STAT_OP(Sub, this->limbs.size());
+    this->accumulate_small(1, true);
+    return *this;
+}
+
+bool operator==(const BigInt &x, const BigInt &y) {
+    BIGINT_STAT_OP(Compare, std::max(x.limbs.size(), y.limbs.size()));
+    return x.cmp(y) == 2;
+}
+
+bool operator!=(const BigInt &x, const BigInt &y) {
+    BIGINT_STAT_OP(Compare, std::max(x.limbs.size(), y.limbs.size()));
+    return x.cmp(y) != 2;
+}
+
+bool operator<(const BigInt &x, const BigInt &y) {
+    BIGINT_STAT_OP(Compare, std::max(x.limbs.size(), y.limbs.size()));
+    return x.cmp(y) == 1;
+}
+
+bool operator>(const BigInt &x, const BigInt &y) {
+    BIGINT_STAT_OP(Compare, std::max(x.limbs.size(), y.limbs.size()));
+    return x.cmp(y) == 0;
+}
+
+bool operator<=(const BigInt &x, const BigInt &y) {
+    BIGINT_STAT_OP(Compare, std::max(x.limbs.size(), y.limbs.size()));
+    return x.cmp(y) != 0;
+}
+
+bool operator>=(const BigInt &x, const BigInt &y) {
+    BIGINT_STAT_OP(Compare, std::max(x.limbs.size(), y.limbs.size()));
+    return x.cmp(y) != 1;
+}
+
+int BigInt::size() const {
+//    Number of decimal digits. With b bits the number lies in [2^(b - 1), 2 * 2^(b - 1)), so it has as
+//    many digits as 2^(b - 1), floor((b - 1) log10 2) + 1, or one more once it reaches the next power
+//    of ten; log10 2 is taken to 128 bits, which no b of a countable size can round wrong.
+    if (this->limbs.empty()) { return 1; }
+    const dlimb k = this->limbs.size() * 64 - __builtin_clzll(this->limbs.back()) - 1;
+    const size_t digits = static_cast<size_t>((k * LOG10_2_HIGH + ((k * LOG10_2_LOW) >> 64)) >> 64) + 1;
+    if (digits <= static_cast<size_t>(DEC_DIGITS)) {
+        limb p = 1;
+        for (size_t i = 0; i < digits; i++) { p *= 10; }
+        return static_cast<int>(this->limbs.size() > 1 || this->limbs[0] >= p ? digits + 1 : digits);
+    }
+    return static_cast<int>(cmp_limbs(this->limbs, power_of_ten(digits)) >= 0 ? digits + 1 : digits);
+}
@@ -1,99 +1,391 @@
-//
-//@brief: Definitions for BigInt class.
-//@copyright: Copyright NPU-Franklin 2020
-//@license: MIT License
-//@birth: created by NPU-Franklin 2020-3-31
-//@version: 4.0.2
-//@revision: last revised by NPU-Franklin 2020-4-4
-//
-
-#ifndef BIGINT_BIGINT_H
-#define BIGINT_BIGINT_H
-#pragma once
-
-#include <vector>
-#include <string>
-
-class BigInt {
-    /**
-     *  Define a BigInt class which can do mathematical operations include plus, minus, multiplication,
-     * division and so on on BigInt.The operations is just the same as what we can do on int type.
-     * ATTENTION: When you do division on two BigInt developer offered you two ways:
-     * (Suppose we have BigInt a, b;)
-     *  1. a / b with no decimal
-     *  2. a.divide(b, <decimal digit>)
-     */
-    friend std::istream &operator>>(std::istream &, BigInt &);
-
-    friend std::ostream &operator<<(std::ostream &, const BigInt &);
-
-    friend BigInt operator+(BigInt &, BigInt &);
-
-    friend BigInt operator-(BigInt &, BigInt &);
-
-    friend BigInt operator*(BigInt &, BigInt &);
-
-    friend BigInt operator/(BigInt &, BigInt &);
-
-    friend BigInt operator%(BigInt &, BigInt &);
-
-    friend BigInt operator+=(BigInt &, BigInt &);
-
-    friend BigInt operator-=(BigInt &, BigInt &);
-
-    friend BigInt operator*=(BigInt &, BigInt &);
-
-    friend BigInt operator/=(BigInt &, BigInt &);
-
-    friend BigInt operator%=(BigInt &, BigInt &);
-
-    friend BigInt pow(BigInt &, int);
-
-    friend bool operator==(const BigInt &, const BigInt &);
-
-    friend bool operator!=(const BigInt &, const BigInt &);
-
-    friend bool operator<(const BigInt &, const BigInt &);
-
-    friend bool operator>(const BigInt &, const BigInt &);
-
-    friend bool operator<=(const BigInt &, const BigInt &);
-
-    friend bool operator>=(const BigInt &, const BigInt &);
-
-public:
-    BigInt() = default;
-
-    ~BigInt() = default;
-
-    BigInt &operator=(std::string &);
-
-    BigInt &operator++(int);
-
-    BigInt &operator++();
-
-    BigInt &operator--(int);
-
-    BigInt &operator--();
-
-    inline int size() const;
-
-    BigInt divide(const BigInt &, int = 0) const;
-
-private:
-    std::vector<double> bigint;
-
-private:
-    int cmp(const BigInt &) const;
-
-    BigInt add(const BigInt &) const;
-
-    BigInt minus(const BigInt &) const;
-
-    BigInt multiply(const BigInt &) const;
-
-    BigInt mod(const BigInt &) const;
-};
-
-
-#endif //BIGINT_BIGINT_H
+//
+//@brief: Definitions for BigInt class.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2020-3-31
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_BIGINT_H
+#define BIGINT_BIGINT_H
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include <string>
+#include <utility>
+#include "Memory.h"
+
+class ThreadPool;
+
+class BigDecimal;
+
+class BigInt {
+    /**
+     *  Define a BigInt class which can do mathematical operations include plus, minus, multiplication,
+     * division and so on on BigInt.The operations is just the same as what we can do on int type.
+     *  The magnitude is stored as base 2^64 limbs (least significant limb first) and the sign is kept
+     * in a separate field, so there are no sentinels inside the limb vector.
+     * ATTENTION: When you do division on two BigInt developer offered you two ways:
+     * (Suppose we have BigInt a, b;)
+     *  1. a / b with no decimal
+     *  2. a.divide(b, <decimal digit>), a BigDecimal (BigDecimal.h) with that many digits after the point
+     *  a.divmod(b, q, r) gives both the quotient and the remainder of a single division.
+     *  Operators never modify their operands, so a BigInt can be read by several threads at once.
+     * Temporaries on either side of + - * lend their storage to the result, and += -= *= work in place.
+     *  Values of up to two limbs live inside the object. Built-in integers (signed or unsigned, up to
+     * 64 bits) convert implicitly, and + - * / % and the comparisons against them work on the limbs
+     * in a single pass instead of building a BigInt; a / b and a % b follow int type with b of any sign.
+     * mul_small(), divmod_small() and mod_small() are the same passes on the magnitude: scale by a
+     * word, divide by a word keeping the remainder (one digit of a base conversion), and take a
+     * checksum modulo a word.
+     *  serialize() writes the binary form: a varint of (limb count << 1 | sign) and then the limbs as
+     * 8 little-endian bytes each, least significant first. It goes straight into a caller's buffer
+     * or stream from the limb storage, and deserialize() reads one back into the storage of an
+     * existing BigInt from a span (a file mapping, a network buffer) or a stream. Values are self
+     * delimiting, so a sequence of them is just their forms one after the other.
+     */
+    friend std::istream &operator>>(std::istream &, BigInt &);
+
+    friend std::ostream &operator<<(std::ostream &, const BigInt &);
+
+    friend BigInt operator+(const BigInt &, const BigInt &);
+
+    friend BigInt operator+(BigInt &&, const BigInt &);
+
+    friend BigInt operator+(const BigInt &, BigInt &&);
+
+    friend BigInt operator+(BigInt &&, BigInt &&);
+
+    friend BigInt operator-(const BigInt &, const BigInt &);
+
+    friend BigInt operator-(BigInt &&, const BigInt &);
+
+    friend BigInt operator-(const BigInt &, BigInt &&);
+
+    friend BigInt operator-(BigInt &&, BigInt &&);
+
+    friend BigInt operator*(const BigInt &, const BigInt &);
+
+    friend BigInt operator*(BigInt &&, const BigInt &);
+
+    friend BigInt operator/(const BigInt &, const BigInt &);
+
+    friend BigInt operator%(const BigInt &, const BigInt &);
+
+    friend BigInt &operator+=(BigInt &, const BigInt &);
+
+    friend BigInt &operator-=(BigInt &, const BigInt &);
+
+    friend BigInt &operator*=(BigInt &, const BigInt &);
+
+    friend BigInt &operator/=(BigInt &, const BigInt &);
+
+    friend BigInt &operator%=(BigInt &, const BigInt &);
+
+    friend BigInt pow(const BigInt &, int);
+
+    friend BigInt pow(const BigInt &, const BigInt &);
+
+    friend BigInt powmod(const BigInt &, const BigInt &, const BigInt &);
+
+    friend BigInt mulmod(const BigInt &, const BigInt &, const BigInt &);
+
+    friend class ModularContext;
+
+    friend class Batch;
+
+    friend class BigDecimal;
+
+    friend class MappedInt;
+
+    friend class PreparedInt;
+
+    friend class TransformCache;
+
+    template<std::size_t>
+    friend class FixedInt;
+
+    friend bool operator==(const BigInt &, const BigInt &);
+
+    friend bool operator!=(const BigInt &, const BigInt &);
+
+    friend bool operator<(const BigInt &, const BigInt &);
+
+    friend bool operator>(const BigInt &, const BigInt &);
+
+    friend bool operator<=(const BigInt &, const BigInt &);
+
+    friend bool operator>=(const BigInt &, const BigInt &);
+
+//    Mixed operations with built-in integers work on the limbs of the BigInt operand directly.
+    template<std::integral T>
+    friend BigInt &operator+=(BigInt &a, T b) {
+        return a.add_small(magnitude_of(b), is_negative(b));
+    }
+
+    template<std::integral T>
+    friend BigInt &operator-=(BigInt &a, T b) {
+        return a.sub_small(magnitude_of(b), is_negative(b));
+    }
+
+    template<std::integral T>
+    friend BigInt &operator*=(BigInt &a, T b) {
+        a.mul_small(magnitude_of(b));
+        a.negative = a.negative != (is_negative(b) && !a.limbs.empty());
+        return a;
+    }
+
+    template<std::integral T>
+    friend BigInt &operator/=(BigInt &a, T b) {
+        a.divmod_small(magnitude_of(b));
+        a.negative = a.negative != (is_negative(b) && !a.limbs.empty());
+        return a;
+    }
+
+    template<std::integral T>
+    friend BigInt &operator%=(BigInt &a, T b) {
+        return a.assign_small(a.mod_small(magnitude_of(b)), a.negative);
+    }
+
+    template<std::integral T>
+    friend BigInt operator+(BigInt a, T b) { return std::move(a += b); }
+
+    template<std::integral T>
+    friend BigInt operator+(T a, BigInt b) { return std::move(b += a); }
+
+    template<std::integral T>
+    friend BigInt operator-(BigInt a, T b) { return std::move(a -= b); }
+
+    template<std::integral T>
+    friend BigInt operator-(T a, BigInt b) {
+//        a - b = -(b - a).
+        b -= a;
+        b.negative = !b.negative && !b.limbs.empty();
+        return b;
+    }
+
+    template<std::integral T>
+    friend BigInt operator*(BigInt a, T b) { return std::move(a *= b); }
+
+    template<std::integral T>
+    friend BigInt operator*(T a, BigInt b) { return std::move(b *= a); }
+
+    template<std::integral T>
+    friend BigInt operator/(BigInt a, T b) { return std::move(a /= b); }
+
+    template<std::integral T>
+    friend BigInt operator%(const BigInt &a, T b) {
+        BigInt r;
+        r.assign_small(a.mod_small(magnitude_of(b)), a.negative);
+        return r;
+    }
+
+    template<std::integral T>
+    friend bool operator==(const BigInt &a, T b) { return a.cmp_small(magnitude_of(b), is_negative(b)) == 2; }
+
+    template<std::integral T>
+    friend bool operator!=(const BigInt &a, T b) { return a.cmp_small(magnitude_of(b), is_negative(b)) != 2; }
+
+    template<std::integral T>
+    friend bool operator<(const BigInt &a, T b) { return a.cmp_small(magnitude_of(b), is_negative(b)) == 1; }
+
+    template<std::integral T>
+    friend bool operator>(const BigInt &a, T b) { return a.cmp_small(magnitude_of(b), is_negative(b)) == 0; }
+
+    template<std::integral T>
+    friend bool operator<=(const BigInt &a, T b) { return a.cmp_small(magnitude_of(b), is_negative(b)) != 0; }
+
+    template<std::integral T>
+    friend bool operator>=(const BigInt &a, T b) { return a.cmp_small(magnitude_of(b), is_negative(b)) != 1; }
+
+    template<std::integral T>
+    friend bool operator==(T a, const BigInt &b) { return b == a; }
+
+    template<std::integral T>
+    friend bool operator!=(T a, const BigInt &b) { return b != a; }
+
+    template<std::integral T>
+    friend bool operator<(T a, const BigInt &b) { return b > a; }
+
+    template<std::integral T>
+    friend bool operator>(T a, const BigInt &b) { return b < a; }
+
+    template<std::integral T>
+    friend bool operator<=(T a, const BigInt &b) { return b >= a; }
+
+    template<std::integral T>
+    friend bool operator>=(T a, const BigInt &b) { return b <= a; }
+
+public:
+    typedef std::uint64_t limb;
+
+    enum class MultiplyEngine {
+        FFT,    // complex double FFT, kept for comparison
+        NTT     // exact three-prime number theoretic transform, the default
+    };
+
+    struct Term {
+//        One signed summand of a lazy expression: x, or x * y when y is set.
+        const BigInt *x;
+        const BigInt *y;
+        bool negative;
+    };
+
+    struct MultiplyThresholds {
+//        Length in limbs of the smaller operand from which each algorithm takes over.
+        std::size_t karatsuba = 32;
+        std::size_t toom3 = 192;
+        std::size_t transform = 3072;
+        std::size_t parallel = 16384;   // the transform runs on the thread pool from here on
+    };
+
+    BigInt() = default;
+
+    template<std::integral T>
+    BigInt(T v) : negative(is_negative(v)) {
+        if (v != 0) { this->limbs.push_back(magnitude_of(v)); }
+    }
+
+    explicit BigInt(const std::string &);
+
+    BigInt(const BigInt &) = default;
+
+    BigInt(BigInt &&) noexcept = default;
+
+    ~BigInt() = default;
+
+    BigInt &operator=(const BigInt &) = default;
+
+    BigInt &operator=(BigInt &&) noexcept = default;
+
+    template<std::integral T>
+    BigInt &operator=(T v) { return this->assign_small(magnitude_of(v), is_negative(v)); }
+
+    BigInt &operator=(const std::string &);
+
+    template<class E>
+    requires requires(const E &e, BigInt &d) { e.assign_to(d); }
+    BigInt &operator=(const E &e) {
+//        Assignment from a lazy expression of BigIntExpr.h, evaluated into this object's storage.
+        e.assign_to(*this);
+        return *this;
+    }
+
+    BigInt operator++(int);
+
+    BigInt &operator++();
+
+    BigInt operator--(int);
+
+    BigInt &operator--();
+
+    int size() const;
+
+    std::string to_string(int base = 10) const;
+
+    static BigInt from_string(const std::string &, int base = 10);
+
+    std::size_t serialized_size() const;
+
+    std::size_t serialize(std::span<std::byte>) const;
+
+    void serialize(std::ostream &) const;
+
+    static std::size_t deserialize(std::span<const std::byte>, BigInt &);
+
+    static void deserialize(std::istream &, BigInt &);
+
+    BigInt square() const;
+
+    BigInt &mul_small(limb);
+
+    limb divmod_small(limb);
+
+    limb mod_small(limb) const;
+
+    BigDecimal divide(const BigInt &, int = 0) const;
+
+    void divmod(const BigInt &, BigInt &, BigInt &) const;
+
+    std::pair<BigInt, BigInt> divmod(const BigInt &) const;
+
+    static void evaluate(BigInt &, const Term *, std::size_t);
+
+    static void set_multiply_engine(MultiplyEngine);
+
+    static MultiplyEngine multiply_engine();
+
+    static void set_multiply_thresholds(const MultiplyThresholds &);
+
+    static MultiplyThresholds multiply_thresholds();
+
+    static MultiplyThresholds tune_multiply();
+
+    static void set_thread_count(unsigned);
+
+    static unsigned thread_count();
+
+    static void set_thread_pool(std::shared_ptr<ThreadPool>);
+
+    static void set_parallel_cutoff(std::size_t);
+
+    static std::size_t parallel_cutoff();
+
+    static void set_allocator(memory::AllocateFn, memory::DeallocateFn);
+
+private:
+    Limbs limbs;                // magnitude, least significant limb first, no leading zero limbs
+    bool negative = false;      // sign of the number, never set for zero
+
+private:
+    void normalize();
+
+    void accumulate(const BigInt &, bool);
+
+    void accumulate(const limb *, std::size_t, bool);
+
+    void accumulate_small(limb, bool);
+
+    BigInt &assign_small(limb, bool);
+
+    BigInt &add_small(limb, bool);
+
+    BigInt &sub_small(limb, bool);
+
+    int cmp(const BigInt &) const;
+
+    int cmp_small(limb, bool) const;
+
+    BigInt add(const BigInt &) const;
+
+    BigInt minus(const BigInt &) const;
+
+    BigInt multiply(const BigInt &) const;
+
+    template<std::integral T>
+    static constexpr bool is_negative(T v) {
+        if constexpr (std::is_signed_v<T>) { return v < 0; }
+        else { return false; }
+    }
+
+    template<std::integral T>
+    static constexpr limb magnitude_of(T v) {
+//        Negating after the widening conversion also covers the most negative value of T.
+        static_assert(sizeof(T) <= sizeof(limb), "Built-in integers wider than a limb are not supported.");
+        return is_negative(v) ? -static_cast<limb>(v) : static_cast<limb>(v);
+    }
+};
+
+
+//    divide() returns a BigDecimal, which needs the complete BigInt.
+#include "BigDecimal.h"
+
+#endif //BIGINT_BIGINT_H
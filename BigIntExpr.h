@@ -0,0 +1,163 @@
+//
+//@brief: Opt-in expression templates for lazy evaluation of compound BigInt expressions.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_BIGINTEXPR_H
+#define BIGINT_BIGINTEXPR_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include "BigInt.h"
+
+namespace expr {
+    /**
+     *  An operator with a lazy() operand builds a node instead of computing, and so does every operator
+     * applied to a node; operators between plain BigInts stay eager. So each product needs a lazy factor:
+     *      r = expr::lazy(a) * b + expr::lazy(c) * d - e;
+     * whereas in lazy(a) * b + c * d the product c * d is computed into a temporary first.
+     *  The tree is flattened into signed summands when it is assigned (or converted) to a BigInt.
+     * Plain summands of each sign are added in a single carry pass, products are folded into the
+     * destination as they are produced (a * b + c needs no BigInt for a * b), x * x goes to the
+     * squaring paths, and the destination's storage is reused unless it is an operand.
+     *  Other subexpressions used as a factor, like (a + b) * c, are evaluated into a temporary first.
+     * An expression refers to its operands, so evaluate it within the statement that builds it.
+     */
+    template<class E>
+    concept Expr = requires { typename E::is_expr; };
+
+    template<class B>
+    concept Operand = std::is_same_v<std::remove_cvref_t<B>, BigInt>;     // any value category, so these
+                                                                          // beat the BigInt friend operators
+    template<class E>
+    struct Base {
+        using is_expr = void;
+
+        void assign_to(BigInt &dst) const {
+            const E &self = static_cast<const E &>(*this);
+            std::array<BigInt::Term, E::terms> terms;
+            std::array<BigInt, E::temps> temps;
+            BigInt::Term *t = terms.data();
+            BigInt *tmp = temps.data();
+            self.collect(false, t, tmp);
+            BigInt::evaluate(dst, terms.data(), terms.size());
+        }
+
+        operator BigInt() const {
+            BigInt result;
+            this->assign_to(result);
+            return result;
+        }
+    };
+
+    struct Leaf : Base<Leaf> {
+        static constexpr std::size_t terms = 1;
+        static constexpr std::size_t temps = 0;
+        const BigInt *value;
+
+        explicit Leaf(const BigInt &x) : value(&x) {}
+
+        void collect(bool negative, BigInt::Term *&t, BigInt *&) const {
+            *t++ = BigInt::Term{value, nullptr, negative};
+        }
+    };
+
+    template<class E>
+    const BigInt *factor_of(const E &e, BigInt *&tmp) {
+//        A factor of a product has to be a BigInt: leaves are used directly, the rest is evaluated.
+        if constexpr (std::is_same_v<E, Leaf>) { return e.value; }
+        else {
+            e.assign_to(*tmp);
+            return tmp++;
+        }
+    }
+
+    template<class E>
+    constexpr std::size_t temps_as_factor() {
+        return std::is_same_v<E, Leaf> ? 0 : 1;
+    }
+
+    template<class L, class R, bool Subtract>
+    struct Sum : Base<Sum<L, R, Subtract>> {
+        static constexpr std::size_t terms = L::terms + R::terms;
+        static constexpr std::size_t temps = L::temps + R::temps;
+        L left;
+        R right;
+
+        Sum(const L &l, const R &r) : left(l), right(r) {}
+
+        void collect(bool negative, BigInt::Term *&t, BigInt *&tmp) const {
+            left.collect(negative, t, tmp);
+            right.collect(negative != Subtract, t, tmp);
+        }
+    };
+
+    template<class L, class R>
+    struct Product : Base<Product<L, R>> {
+        static constexpr std::size_t terms = 1;
+        static constexpr std::size_t temps = temps_as_factor<L>() + temps_as_factor<R>();
+        L left;
+        R right;
+
+        Product(const L &l, const R &r) : left(l), right(r) {}
+
+        void collect(bool negative, BigInt::Term *&t, BigInt *&tmp) const {
+            const BigInt *x = factor_of(left, tmp);
+            const BigInt *y = factor_of(right, tmp);
+            *t++ = BigInt::Term{x, y, negative};
+        }
+    };
+
+    inline Leaf lazy(const BigInt &x) {
+        return Leaf(x);
+    }
+
+    template<Expr L, Expr R>
+    Sum<L, R, false> operator+(const L &l, const R &r) { return {l, r}; }
+
+    template<Expr L, Operand B>
+    Sum<L, Leaf, false> operator+(const L &l, B &&r) { return {l, Leaf(r)}; }
+
+    template<Operand B, Expr R>
+    Sum<Leaf, R, false> operator+(B &&l, const R &r) { return {Leaf(l), r}; }
+
+    template<Expr L, Expr R>
+    Sum<L, R, true> operator-(const L &l, const R &r) { return {l, r}; }
+
+    template<Expr L, Operand B>
+    Sum<L, Leaf, true> operator-(const L &l, B &&r) { return {l, Leaf(r)}; }
+
+    template<Operand B, Expr R>
+    Sum<Leaf, R, true> operator-(B &&l, const R &r) { return {Leaf(l), r}; }
+
+    template<Expr L, Expr R>
+    Product<L, R> operator*(const L &l, const R &r) { return {l, r}; }
+
+    template<Expr L, Operand B>
+    Product<L, Leaf> operator*(const L &l, B &&r) { return {l, Leaf(r)}; }
+
+    template<Operand B, Expr R>
+    Product<Leaf, R> operator*(B &&l, const R &r) { return {Leaf(l), r}; }
+
+    template<Expr E>
+    BigInt &operator+=(BigInt &dst, const E &e) {
+//        dst + e keeps dst as the starting value and accumulates into its storage.
+        dst = lazy(dst) + e;
+        return dst;
+    }
+
+    template<Expr E>
+    BigInt &operator-=(BigInt &dst, const E &e) {
+        dst = lazy(dst) - e;
+        return dst;
+    }
+}
+
+
+#endif //BIGINT_BIGINTEXPR_H
@@ -0,0 +1,227 @@
+//
+//@brief: Implementations of the division engine used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Divide.h"
+#include "Kernel.h"
+#include "Multiply.h"
+#include "Stats.h"
+#include <algorithm>
+
+typedef std::uint64_t limb;
+typedef unsigned __int128 dlimb;
+typedef Limbs Nat;
+
+const std::size_t BZ_THRESHOLD = 80;    // divisor limbs below which Algorithm D is faster
+
+static void nat_trim(Nat &a) {
+    while (!a.empty() && a.back() == 0) { a.pop_back(); }
+}
+
+static int nat_cmp(const Nat &a, const Nat &b) {
+    if (a.size() != b.size()) { return a.size() < b.size() ? -1 : 1; }
+    return kernel::cmp_n(a.data(), b.data(), a.size());
+}
+
+static std::size_t nat_bitlen(const Nat &a) {
+    return a.empty() ? 0 : 64 * a.size() - __builtin_clzll(a.back());
+}
+
+//a += b * B^k.
+static void nat_add_at(Nat &a, const Nat &b, std::size_t k) {
+    if (b.empty()) { return; }
+    if (a.size() < k + b.size()) { a.resize(k + b.size()); }
+    a.push_back(0);
+    kernel::add(a.data() + k, a.data() + k, a.size() - k, b.data(), b.size());
+    nat_trim(a);
+}
+
+//a -= b, requires a >= b.
+static void nat_sub(Nat &a, const Nat &b) {
+    kernel::sub(a.data(), a.data(), a.size(), b.data(), b.size());
+    nat_trim(a);
+}
+
+static Nat nat_mul(const Nat &a, const Nat &b) {
+    Nat r;
+    if (a.empty() || b.empty()) { return r; }
+    r.resize(a.size() + b.size());
+    BIGINT_STAT_ALLOC(r.size() * sizeof(limb));
+    multiply_limbs(r.data(), a.data(), a.size(), b.data(), b.size());
+    nat_trim(r);
+    return r;
+}
+
+//a / B^k.
+static Nat nat_high(const Nat &a, std::size_t k) {
+    return k >= a.size() ? Nat() : Nat(a.begin() + k, a.end());
+}
+
+//a mod B^k.
+static Nat nat_low(const Nat &a, std::size_t k) {
+    Nat r(a.begin(), a.begin() + std::min(k, a.size()));
+    nat_trim(r);
+    return r;
+}
+
+//high * B^k + low, requires low < B^k.
+static Nat nat_join(const Nat &high, const Nat &low, std::size_t k) {
+    if (high.empty()) { return low; }
+    Nat r(k + high.size(), 0);
+    std::copy(low.begin(), low.end(), r.begin());
+    std::copy(high.begin(), high.end(), r.begin() + k);
+    return r;
+}
+
+//a * 2^s.
+static Nat nat_shl(const Nat &a, std::size_t s) {
+    if (a.empty()) { return a; }
+    std::size_t limbs = s / 64;
+    unsigned bits = s % 64;
+    Nat r(a.size() + limbs + 1, 0);
+    for (std::size_t i = 0; i < a.size(); i++) {
+        r[i + limbs] |= a[i] << bits;
+        if (bits != 0) { r[i + limbs + 1] = a[i] >> (64 - bits); }
+    }
+    nat_trim(r);
+    return r;
+}
+
+//a / 2^s.
+static Nat nat_shr(const Nat &a, std::size_t s) {
+    std::size_t limbs = s / 64;
+    unsigned bits = s % 64;
+    if (limbs >= a.size()) { return Nat(); }
+    Nat r(a.size() - limbs);
+    for (std::size_t i = 0; i < r.size(); i++) {
+        r[i] = a[i + limbs] >> bits;
+        if (bits != 0 && i + limbs + 1 < a.size()) { r[i] |= a[i + limbs + 1] << (64 - bits); }
+    }
+    nat_trim(r);
+    return r;
+}
+
+//Knuth's Algorithm D (TAOCP vol. 2, 4.3.1).
+static void div_knuth(const Nat &a, const Nat &b, Nat &q, Nat &r) {
+    BIGINT_STAT_TIER(Knuth);
+    if (nat_cmp(a, b) < 0) {
+        q.clear();
+        r = a;
+        return;
+    }
+    std::size_t n = a.size(), m = b.size();
+    if (m == 1) {
+        q.resize(n);
+        r.assign(1, kernel::divmod_1(q.data(), a.data(), n, b[0]));
+        nat_trim(q);
+        nat_trim(r);
+        return;
+    }
+
+//    Normalize so that the top bit of the divisor is set.
+    unsigned s = __builtin_clzll(b[m - 1]);
+    Nat bn = nat_shl(b, s), an = nat_shl(a, s);
+    BIGINT_STAT_ALLOC((bn.size() + an.size() + n - m + 2) * sizeof(limb));
+    an.resize(n + 1, 0);
+    q.assign(n - m + 1, 0);
+    const limb top = bn[m - 1], next = bn[m - 2];
+
+    for (std::size_t j = n - m + 1; j-- > 0;) {
+//        Estimate the quotient digit from the top two limbs, it is then at most one too large.
+        dlimb num = (static_cast<dlimb>(an[j + m]) << 64) | an[j + m - 1];
+        dlimb qhat = num / top, rhat = num % top;
+        while ((qhat >> 64) != 0 || qhat * next > ((rhat << 64) | an[j + m - 2])) {
+            qhat--;
+            rhat += top;
+            if ((rhat >> 64) != 0) { break; }
+        }
+        limb borrow = kernel::submul_1(an.data() + j, bn.data(), m, static_cast<limb>(qhat));
+        limb high = an[j + m];
+        an[j + m] = high - borrow;
+        if (high < borrow) {
+//            Add back.
+            qhat--;
+            an[j + m] += kernel::add_n(an.data() + j, an.data() + j, bn.data(), m);
+        }
+        q[j] = static_cast<limb>(qhat);
+    }
+    an.resize(m);
+    nat_trim(an);
+    r = nat_shr(an, s);
+    nat_trim(q);
+}
+
+static void div_2n1n(const Nat &a, const Nat &b, std::size_t n, Nat &q, Nat &r);
+
+//divide [a1, a2, a3] by [b1, b2] where every block has half limbs and a < b * B^half.
+static void div_3n2n(const Nat &a, const Nat &b, std::size_t half, Nat &q, Nat &r) {
+    Nat a12 = nat_high(a, half), b1 = nat_high(b, half), b2 = nat_low(b, half);
+    Nat r1;
+    if (nat_cmp(nat_high(a, 2 * half), b1) < 0) {
+        div_2n1n(a12, b1, half, q, r1);
+    } else {
+//        a1 == b1: the quotient estimate is B^half - 1 and r1 = a12 - q * b1 = a2 + b1.
+        q.assign(half, ~limb(0));
+        r1 = a12;
+        nat_add_at(r1, b1, 0);
+        nat_sub(r1, nat_join(b1, Nat(), half));
+    }
+    Nat d = nat_mul(q, b2);
+    r = nat_join(r1, nat_low(a, half), half);
+//    The estimate is at most two too large.
+    while (nat_cmp(r, d) < 0) {
+        nat_add_at(r, b, 0);
+        nat_sub(q, Nat(1, 1));
+    }
+    nat_sub(r, d);
+}
+
+//divide a by the n-limb normalized b, where a < b * B^n.
+static void div_2n1n(const Nat &a, const Nat &b, std::size_t n, Nat &q, Nat &r) {
+    if (n % 2 != 0 || n < BZ_THRESHOLD) {
+        div_knuth(a, b, q, r);
+        return;
+    }
+    std::size_t half = n / 2;
+    Nat q1, r1, q2;
+    div_3n2n(nat_high(a, half), b, half, q1, r1);
+    div_3n2n(nat_join(r1, nat_low(a, half), half), b, half, q2, r);
+    q = nat_join(q1, q2, half);
+}
+
+void divide_limbs(const Nat &a, const Nat &b, Nat &q, Nat &r) {
+    std::size_t s = b.size();
+    if (nat_cmp(a, b) < 0 || s < BZ_THRESHOLD || a.size() - s < BZ_THRESHOLD) {
+        div_knuth(a, b, q, r);
+        return;
+    }
+
+    BIGINT_STAT_TIER(BurnikelZiegler);
+//    Pad the divisor to n = j * m limbs with its top bit set, m a power of two so that the
+//    recursion halves it down to j < BZ_THRESHOLD limbs.
+    std::size_t m = 1;
+    while (m <= s / BZ_THRESHOLD) { m <<= 1; }
+    std::size_t n = (s + m - 1) / m * m;
+    std::size_t sigma = 64 * n - nat_bitlen(b);
+    Nat bs = nat_shl(b, sigma), as = nat_shl(a, sigma);
+
+//    Split the dividend into t blocks of n limbs, the top block having its top bit clear.
+    std::size_t t = std::max<std::size_t>((nat_bitlen(as) + 64 * n) / (64 * n), 2);
+    Nat z = nat_high(as, (t - 2) * n), qi, ri;
+    q.clear();
+    for (std::size_t i = t - 2; i > 0; i--) {
+        div_2n1n(z, bs, n, qi, ri);
+        Nat block(as.begin() + std::min((i - 1) * n, as.size()), as.begin() + std::min(i * n, as.size()));
+        nat_trim(block);
+        z = nat_join(ri, block, n);
+        nat_add_at(q, qi, i * n);
+    }
+    div_2n1n(z, bs, n, qi, ri);
+    nat_add_at(q, qi, 0);
+    r = nat_shr(ri, sigma);
+}
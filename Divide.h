@@ -0,0 +1,27 @@
+//
+//@brief: Definitions for the division engine used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_DIVIDE_H
+#define BIGINT_DIVIDE_H
+#pragma once
+
+#include <cstdint>
+#include "Memory.h"
+
+/**
+ *  Divide the magnitude a by the non-zero magnitude b (base 2^64 limbs, least significant limb first,
+ * no leading zero limbs), writing q = a / b and r = a % b in the same form.
+ *  Short divisors and short quotients use Knuth's Algorithm D, everything else goes through
+ * Burnikel-Ziegler recursive division, which does its work in multiplications and therefore
+ * inherits the subquadratic multiply_limbs() tiers.
+ */
+void divide_limbs(const Limbs &a, const Limbs &b, Limbs &q, Limbs &r);
+
+
+#endif //BIGINT_DIVIDE_H
@@ -0,0 +1,420 @@
+//
+//@brief: Fixed width integers of a size known at compile time, with the operators of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_FIXEDINT_H
+#define BIGINT_FIXEDINT_H
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "BigInt.h"
+
+namespace fixed {
+//    f(0), f(1), ..., f(N - 1) with the index as a constant, so every step of the loop is spelled out.
+    template<std::size_t N, class F>
+    constexpr void unroll(F &&f) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (f(std::integral_constant<std::size_t, I>()), ...);
+        }(std::make_index_sequence<N>());
+    }
+}
+
+template<std::size_t Bits>
+class FixedInt {
+    /**
+     *  A signed integer of exactly Bits bits (a multiple of 64) in two's complement, for the 256, 512
+     * and 1024 bit values of hashes, IDs and checksums. The limbs live inside the object, loops over
+     * them have a length known at compile time and are spelled out by fixed::unroll(), and there is
+     * no sign field and no tier dispatch. All of the arithmetic is constexpr:
+     *      constexpr Int256 k = Int256::from_string("ffffffffffffffffffffffffffffffff", 16) * 3;
+     *  The operators are those of BigInt. Like the built-in integer types, results wrap around modulo
+     * 2^Bits instead of growing, / truncates and % takes the sign of the dividend. BigInt(x) and
+     * FixedInt<Bits>(b) convert by copying limbs, the latter keeping the low Bits bits of b the way a
+     * narrowing cast of an integer does.
+     */
+    static_assert(Bits > 0 && Bits % 64 == 0, "FixedInt holds whole 64 bit limbs.");
+
+public:
+    typedef std::uint64_t limb;
+
+    static constexpr std::size_t LIMBS = Bits / 64;
+
+    constexpr FixedInt() = default;
+
+    template<std::integral T>
+    constexpr FixedInt(T v) {
+//        Sign extension of a negative value fills the upper limbs with ones.
+        this->limbs[0] = static_cast<limb>(v);
+        if constexpr (std::is_signed_v<T>) {
+            for (std::size_t i = 1; i < LIMBS; i++) { this->limbs[i] = v < 0 ? ~limb(0) : 0; }
+        }
+    }
+
+    explicit FixedInt(const BigInt &x) {
+        for (std::size_t i = 0; i < LIMBS && i < x.limbs.size(); i++) { this->limbs[i] = x.limbs[i]; }
+        if (x.negative) { *this = -*this; }
+    }
+
+    explicit operator BigInt() const {
+        BigInt result;
+        const FixedInt m = this->magnitude();
+        result.limbs.assign(m.limbs.begin(), m.limbs.end());
+        result.negative = this->is_negative();
+        result.normalize();
+        return result;
+    }
+
+    friend std::istream &operator>>(std::istream &in, FixedInt &x) {
+        std::string tmp;
+        if (in >> tmp) { x = from_string(tmp); }
+        return in;
+    }
+
+    friend std::ostream &operator<<(std::ostream &out, const FixedInt &x) {
+        out << x.to_string();
+        return out;
+    }
+
+    friend constexpr FixedInt operator+(const FixedInt &a, const FixedInt &b) {
+        FixedInt r;
+        limb carry = 0;
+        fixed::unroll<LIMBS>([&](std::size_t i) {
+            dlimb s = static_cast<dlimb>(a.limbs[i]) + b.limbs[i] + carry;
+            r.limbs[i] = static_cast<limb>(s);
+            carry = static_cast<limb>(s >> 64);
+        });
+        return r;
+    }
+
+    friend constexpr FixedInt operator-(const FixedInt &a, const FixedInt &b) {
+        FixedInt r;
+        limb borrow = 0;
+        fixed::unroll<LIMBS>([&](std::size_t i) {
+            limb x = a.limbs[i], y = b.limbs[i];
+            r.limbs[i] = x - y - borrow;
+            borrow = (x < y || (x == y && borrow != 0)) ? 1 : 0;
+        });
+        return r;
+    }
+
+    friend constexpr FixedInt operator*(const FixedInt &a, const FixedInt &b) {
+//        Schoolbook on the limbs below 2^Bits only, which two's complement makes right for any signs.
+        FixedInt r;
+        fixed::unroll<LIMBS>([&](std::size_t i) {
+            limb carry = 0;
+            for (std::size_t j = 0; i + j < LIMBS; j++) {
+                dlimb t = static_cast<dlimb>(a.limbs[i]) * b.limbs[j] + r.limbs[i + j] + carry;
+                r.limbs[i + j] = static_cast<limb>(t);
+                carry = static_cast<limb>(t >> 64);
+            }
+        });
+        return r;
+    }
+
+    friend constexpr FixedInt operator/(const FixedInt &a, const FixedInt &b) {
+        FixedInt q, r;
+        a.divmod(b, q, r);
+        return q;
+    }
+
+    friend constexpr FixedInt operator%(const FixedInt &a, const FixedInt &b) {
+        FixedInt q, r;
+        a.divmod(b, q, r);
+        return r;
+    }
+
+    friend constexpr FixedInt &operator+=(FixedInt &a, const FixedInt &b) { return a = a + b; }
+
+    friend constexpr FixedInt &operator-=(FixedInt &a, const FixedInt &b) { return a = a - b; }
+
+    friend constexpr FixedInt &operator*=(FixedInt &a, const FixedInt &b) { return a = a * b; }
+
+    friend constexpr FixedInt &operator/=(FixedInt &a, const FixedInt &b) { return a = a / b; }
+
+    friend constexpr FixedInt &operator%=(FixedInt &a, const FixedInt &b) { return a = a % b; }
+
+    friend constexpr FixedInt pow(FixedInt a, int n) {
+//        Square and multiply over the bits of n, wrapping like every other operation.
+        if (n < 0) { throw "Invalid exponent."; }
+        FixedInt result = 1;
+        for (; n != 0; n >>= 1) {
+            if ((n & 1) != 0) { result *= a; }
+            a *= a;
+        }
+        return result;
+    }
+
+    friend constexpr bool operator==(const FixedInt &x, const FixedInt &y) { return cmp(x, y) == 0; }
+
+    friend constexpr bool operator!=(const FixedInt &x, const FixedInt &y) { return cmp(x, y) != 0; }
+
+    friend constexpr bool operator<(const FixedInt &x, const FixedInt &y) { return cmp(x, y) < 0; }
+
+    friend constexpr bool operator>(const FixedInt &x, const FixedInt &y) { return cmp(x, y) > 0; }
+
+    friend constexpr bool operator<=(const FixedInt &x, const FixedInt &y) { return cmp(x, y) <= 0; }
+
+    friend constexpr bool operator>=(const FixedInt &x, const FixedInt &y) { return cmp(x, y) >= 0; }
+
+    constexpr FixedInt operator-() const {
+        FixedInt r;
+        limb carry = 1;
+        fixed::unroll<LIMBS>([&](std::size_t i) {
+            r.limbs[i] = ~this->limbs[i] + carry;
+            carry = r.limbs[i] < carry ? 1 : 0;
+        });
+        return r;
+    }
+
+    constexpr FixedInt operator++(int) {
+        FixedInt old = *this;
+        ++*this;
+        return old;
+    }
+
+    constexpr FixedInt &operator++() {
+//        The carry stops at the first limb that does not wrap.
+        for (std::size_t i = 0; i < LIMBS && ++this->limbs[i] == 0; i++) {}
+        return *this;
+    }
+
+    constexpr FixedInt operator--(int) {
+        FixedInt old = *this;
+        --*this;
+        return old;
+    }
+
+    constexpr FixedInt &operator--() {
+        for (std::size_t i = 0; i < LIMBS && this->limbs[i]-- == 0; i++) {}
+        return *this;
+    }
+
+    int size() const {
+//        Number of decimal digits.
+        return static_cast<int>(this->to_string().size()) - (this->is_negative() ? 1 : 0);
+    }
+
+    std::string to_string(int base = 10) const {
+//        Digits in the given base with a leading '-' for negative numbers, a limb worth of digits
+//        per division.
+        if (base < 2 || base > 36) { throw "Invalid base."; }
+        limb chunk = static_cast<limb>(base);
+        int per_chunk = 1;
+        while (chunk <= ~limb(0) / static_cast<limb>(base)) {
+            chunk *= static_cast<limb>(base);
+            per_chunk++;
+        }
+        FixedInt m = this->magnitude();
+        std::string s;
+        do {
+            limb rem = m.divide_limbs(chunk);
+            for (int k = 0; k < per_chunk && (rem != 0 || !m.is_zero()); k++) {
+                int d = static_cast<int>(rem % static_cast<limb>(base));
+                s.push_back(static_cast<char>(d < 10 ? '0' + d : 'a' + d - 10));
+                rem /= static_cast<limb>(base);
+            }
+        } while (!m.is_zero());
+        if (s.empty()) { s.push_back('0'); }
+        if (this->is_negative()) { s.push_back('-'); }
+        return std::string(s.rbegin(), s.rend());
+    }
+
+    static constexpr FixedInt from_string(std::string_view s, int base = 10) {
+//        An optional sign followed by digits in the given base, wrapping modulo 2^Bits.
+        if (base < 2 || base > 36) { throw "Invalid base."; }
+        std::size_t pos = 0;
+        bool neg = false;
+        if (pos < s.size() && (s[pos] == '-' || s[pos] == '+')) { neg = s[pos++] == '-'; }
+        if (pos == s.size()) { throw "Invalid number format."; }
+        FixedInt result;
+        for (; pos < s.size(); pos++) {
+            char c = s[pos];
+            int d = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'z' ? c - 'a' + 10
+                                                     : c >= 'A' && c <= 'Z' ? c - 'A' + 10 : 36;
+            if (d >= base) { throw "Invalid number format."; }
+            result.mul_small(static_cast<limb>(base));
+            result += d;
+        }
+        return neg ? -result : result;
+    }
+
+    constexpr FixedInt square() const {
+        return *this * *this;
+    }
+
+    constexpr FixedInt &mul_small(limb m) {
+//        this *= m in one pass.
+        limb carry = 0;
+        fixed::unroll<LIMBS>([&](std::size_t i) {
+            dlimb t = static_cast<dlimb>(this->limbs[i]) * m + carry;
+            this->limbs[i] = static_cast<limb>(t);
+            carry = static_cast<limb>(t >> 64);
+        });
+        return *this;
+    }
+
+    constexpr limb divmod_small(limb d) {
+//        this /= d truncated, return |this| % d, as BigInt::divmod_small().
+        if (d == 0) { throw "Can't divide by zero."; }
+        const bool neg = this->is_negative();
+        FixedInt m = this->magnitude();
+        limb r = m.divide_limbs(d);
+        *this = neg ? -m : m;
+        return r;
+    }
+
+    constexpr limb mod_small(limb d) const {
+        FixedInt copy = *this;
+        return copy.divmod_small(d);
+    }
+
+    constexpr void divmod(const FixedInt &x, FixedInt &q, FixedInt &r) const {
+//        The quotient is truncated and the remainder takes the sign of the dividend, just like int type.
+        if (x.is_zero()) { throw "Can't divide by zero."; }
+        const bool qneg = this->is_negative() != x.is_negative(), rneg = this->is_negative();
+        FixedInt quotient, remainder;
+        divide_magnitudes(this->magnitude().limbs, x.magnitude().limbs, quotient.limbs, remainder.limbs);
+        q = qneg ? -quotient : quotient;
+        r = rneg ? -remainder : remainder;
+    }
+
+    constexpr std::pair<FixedInt, FixedInt> divmod(const FixedInt &x) const {
+        std::pair<FixedInt, FixedInt> result;
+        this->divmod(x, result.first, result.second);
+        return result;
+    }
+
+private:
+    __extension__ typedef unsigned __int128 dlimb;
+    __extension__ typedef __int128 sdlimb;
+    typedef std::array<limb, LIMBS> LimbArray;
+
+    LimbArray limbs{};  // two's complement, least significant limb first
+
+private:
+    constexpr bool is_negative() const {
+        return (this->limbs[LIMBS - 1] >> 63) != 0;
+    }
+
+    constexpr bool is_zero() const {
+        for (limb x : this->limbs) {
+            if (x != 0) { return false; }
+        }
+        return true;
+    }
+
+    constexpr FixedInt magnitude() const {
+//        |x| read as unsigned, so the most negative value gives 2^(Bits - 1) as it should.
+        return this->is_negative() ? -*this : *this;
+    }
+
+    static constexpr int cmp(const FixedInt &x, const FixedInt &y) {
+//        The top limb carries the sign, the others compare as unsigned.
+        const std::int64_t hx = static_cast<std::int64_t>(x.limbs[LIMBS - 1]);
+        const std::int64_t hy = static_cast<std::int64_t>(y.limbs[LIMBS - 1]);
+        if (hx != hy) { return hx < hy ? -1 : 1; }
+        for (std::size_t i = LIMBS - 1; i-- > 0;) {
+            if (x.limbs[i] != y.limbs[i]) { return x.limbs[i] < y.limbs[i] ? -1 : 1; }
+        }
+        return 0;
+    }
+
+    constexpr limb divide_limbs(limb d) {
+//        The unsigned value of the limbs /= d, return the remainder.
+        dlimb rem = 0;
+        for (std::size_t i = LIMBS; i-- > 0;) {
+            dlimb cur = (rem << 64) | this->limbs[i];
+            this->limbs[i] = static_cast<limb>(cur / d);
+            rem = cur % d;
+        }
+        return static_cast<limb>(rem);
+    }
+
+    static constexpr void divide_magnitudes(const LimbArray &u, const LimbArray &v, LimbArray &q, LimbArray &r) {
+//        Knuth's Algorithm D on unsigned limbs, v is not zero.
+        std::size_t m = LIMBS, n = LIMBS;
+        while (m > 0 && u[m - 1] == 0) { m--; }
+        while (v[n - 1] == 0) { n--; }
+        q = LimbArray{};
+        r = LimbArray{};
+        if (m < n) {
+            r = u;
+            return;
+        }
+        if (n == 1) {
+            dlimb rem = 0;
+            for (std::size_t i = m; i-- > 0;) {
+                dlimb cur = (rem << 64) | u[i];
+                q[i] = static_cast<limb>(cur / v[0]);
+                rem = cur % v[0];
+            }
+            r[0] = static_cast<limb>(rem);
+            return;
+        }
+
+//        Shift both so that the top limb of the divisor has its high bit set.
+        const unsigned s = static_cast<unsigned>(std::countl_zero(v[n - 1]));
+        std::array<limb, LIMBS> vn{};
+        std::array<limb, LIMBS + 1> un{};
+        for (std::size_t i = n - 1; i > 0; i--) { vn[i] = (v[i] << s) | (s != 0 ? v[i - 1] >> (64 - s) : 0); }
+        vn[0] = v[0] << s;
+        un[m] = s != 0 ? u[m - 1] >> (64 - s) : 0;
+        for (std::size_t i = m - 1; i > 0; i--) { un[i] = (u[i] << s) | (s != 0 ? u[i - 1] >> (64 - s) : 0); }
+        un[0] = u[0] << s;
+
+        for (std::size_t j = m - n + 1; j-- > 0;) {
+//            Estimate the quotient limb from the top two limbs, it is at most one too large after this.
+            dlimb num = (static_cast<dlimb>(un[j + n]) << 64) | un[j + n - 1];
+            dlimb qhat = num / vn[n - 1], rhat = num % vn[n - 1];
+            while ((qhat >> 64) != 0 || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+                qhat--;
+                rhat += vn[n - 1];
+                if ((rhat >> 64) != 0) { break; }
+            }
+//            un[j..j+n] -= qhat * vn, and add vn back once if that went below zero.
+            sdlimb k = 0, t = 0;
+            for (std::size_t i = 0; i < n; i++) {
+                dlimb p = qhat * vn[i];
+                t = static_cast<sdlimb>(un[i + j]) - k - static_cast<sdlimb>(static_cast<limb>(p));
+                un[i + j] = static_cast<limb>(t);
+                k = static_cast<sdlimb>(p >> 64) - (t >> 64);
+            }
+            t = static_cast<sdlimb>(un[j + n]) - k;
+            un[j + n] = static_cast<limb>(t);
+            q[j] = static_cast<limb>(qhat);
+            if (t < 0) {
+                q[j]--;
+                limb carry = 0;
+                for (std::size_t i = 0; i < n; i++) {
+                    dlimb sum = static_cast<dlimb>(un[i + j]) + vn[i] + carry;
+                    un[i + j] = static_cast<limb>(sum);
+                    carry = static_cast<limb>(sum >> 64);
+                }
+                un[j + n] += carry;
+            }
+        }
+        for (std::size_t i = 0; i < n; i++) { r[i] = (un[i] >> s) | (s != 0 ? un[i + 1] << (64 - s) : 0); }
+    }
+};
+
+typedef FixedInt<256> Int256;
+typedef FixedInt<512> Int512;
+typedef FixedInt<1024> Int1024;
+
+
+#endif //BIGINT_FIXEDINT_H
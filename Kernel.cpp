@@ -0,0 +1,382 @@
+//
+//@brief: Implementations of the limb kernels shared by the BigInt algorithms.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Kernel.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+typedef unsigned __int128 dlimb;
+
+namespace kernel {
+//    Portable versions, also used for the tails of the vector loops.
+    static limb add_n_scalar(limb *r, const limb *a, const limb *b, std::size_t n, limb carry) {
+        for (std::size_t i = 0; i < n; i++) {
+            dlimb tmp = static_cast<dlimb>(a[i]) + b[i] + carry;
+            r[i] = static_cast<limb>(tmp);
+            carry = static_cast<limb>(tmp >> 64);
+        }
+        return carry;
+    }
+
+    static limb sub_n_scalar(limb *r, const limb *a, const limb *b, std::size_t n, limb borrow) {
+        for (std::size_t i = 0; i < n; i++) {
+            limb x = a[i], y = b[i];
+            r[i] = x - y - borrow;
+            borrow = (x < y || (x == y && borrow)) ? 1 : 0;
+        }
+        return borrow;
+    }
+
+    static int cmp_n_scalar(const limb *a, const limb *b, std::size_t n) {
+        for (std::size_t i = n; i-- > 0;) {
+            if (a[i] != b[i]) { return a[i] < b[i] ? -1 : 1; }
+        }
+        return 0;
+    }
+
+    static std::size_t normalized_size_scalar(const limb *a, std::size_t n) {
+        while (n > 0 && a[n - 1] == 0) { n--; }
+        return n;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+//    Carries between lanes are resolved on bit masks: g marks the lanes whose sum wrapped around
+//    (they generate a carry), p the lanes holding all ones (they pass an incoming carry on). The
+//    lanes to increment are then ((g << 1 | carry_in) + p) ^ p, and the bit above the last lane is
+//    the carry out, so a whole vector costs a few mask operations however far a carry ripples.
+//    Borrows work the same way with the lanes holding zero as p.
+    __attribute__((target("avx512f")))
+    static limb add_n_avx512(limb *r, const limb *a, const limb *b, std::size_t n) {
+        const __m512i ones = _mm512_set1_epi64(-1);
+        unsigned carry = 0;
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512i x = _mm512_loadu_si512(a + i), y = _mm512_loadu_si512(b + i);
+            __m512i sum = _mm512_add_epi64(x, y);
+            unsigned g = _mm512_cmplt_epu64_mask(sum, x), p = _mm512_cmpeq_epi64_mask(sum, ones);
+            unsigned c = ((g << 1) | carry) + p;
+            carry = c >> 8;
+            sum = _mm512_mask_sub_epi64(sum, static_cast<__mmask8>(c ^ p), sum, ones);
+            _mm512_storeu_si512(r + i, sum);
+        }
+        return add_n_scalar(r + i, a + i, b + i, n - i, carry);
+    }
+
+    __attribute__((target("avx512f")))
+    static limb sub_n_avx512(limb *r, const limb *a, const limb *b, std::size_t n) {
+        const __m512i ones = _mm512_set1_epi64(-1);
+        unsigned borrow = 0;
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512i x = _mm512_loadu_si512(a + i), y = _mm512_loadu_si512(b + i);
+            __m512i diff = _mm512_sub_epi64(x, y);
+            unsigned g = _mm512_cmplt_epu64_mask(x, y), p = _mm512_cmpeq_epi64_mask(diff, _mm512_setzero_si512());
+            unsigned c = ((g << 1) | borrow) + p;
+            borrow = c >> 8;
+            diff = _mm512_mask_add_epi64(diff, static_cast<__mmask8>(c ^ p), diff, ones);
+            _mm512_storeu_si512(r + i, diff);
+        }
+        return sub_n_scalar(r + i, a + i, b + i, n - i, borrow);
+    }
+
+    __attribute__((target("avx512f")))
+    static int cmp_n_avx512(const limb *a, const limb *b, std::size_t n) {
+        for (; n >= 8; n -= 8) {
+            unsigned ne = _mm512_cmpneq_epu64_mask(_mm512_loadu_si512(a + n - 8), _mm512_loadu_si512(b + n - 8));
+            if (ne != 0) {
+                std::size_t i = n - 8 + 31 - __builtin_clz(ne);
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return cmp_n_scalar(a, b, n);
+    }
+
+    __attribute__((target("avx512f")))
+    static std::size_t normalized_size_avx512(const limb *a, std::size_t n) {
+        for (; n >= 8; n -= 8) {
+            __m512i v = _mm512_loadu_si512(a + n - 8);
+            unsigned nz = _mm512_test_epi64_mask(v, v);
+            if (nz != 0) { return n - 8 + 32 - __builtin_clz(nz); }
+        }
+        return normalized_size_scalar(a, n);
+    }
+
+    __attribute__((target("avx2")))
+    static inline __m256i lane_mask_avx2(unsigned bits) {
+//        All ones in the lanes whose bit is set.
+        const __m256i select = _mm256_set_epi64x(8, 4, 2, 1);
+        return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(bits), select), select);
+    }
+
+    __attribute__((target("avx2")))
+    static inline unsigned lanes_avx2(__m256i v) {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(v)));
+    }
+
+    __attribute__((target("avx2")))
+    static limb add_n_avx2(limb *r, const limb *a, const limb *b, std::size_t n) {
+//        AVX2 has no unsigned compare: flipping the sign bits turns it into a signed one.
+        const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+        const __m256i ones = _mm256_set1_epi64x(-1);
+        unsigned carry = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+            __m256i sum = _mm256_add_epi64(x, y);
+            unsigned g = lanes_avx2(_mm256_cmpgt_epi64(_mm256_xor_si256(x, sign), _mm256_xor_si256(sum, sign)));
+            unsigned p = lanes_avx2(_mm256_cmpeq_epi64(sum, ones));
+            unsigned c = ((g << 1) | carry) + p;
+            carry = c >> 4;
+            sum = _mm256_sub_epi64(sum, lane_mask_avx2((c ^ p) & 0xF));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), sum);
+        }
+        return add_n_scalar(r + i, a + i, b + i, n - i, carry);
+    }
+
+    __attribute__((target("avx2")))
+    static limb sub_n_avx2(limb *r, const limb *a, const limb *b, std::size_t n) {
+        const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+        unsigned borrow = 0;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+            __m256i diff = _mm256_sub_epi64(x, y);
+            unsigned g = lanes_avx2(_mm256_cmpgt_epi64(_mm256_xor_si256(y, sign), _mm256_xor_si256(x, sign)));
+            unsigned p = lanes_avx2(_mm256_cmpeq_epi64(diff, _mm256_setzero_si256()));
+            unsigned c = ((g << 1) | borrow) + p;
+            borrow = c >> 4;
+            diff = _mm256_add_epi64(diff, lane_mask_avx2((c ^ p) & 0xF));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), diff);
+        }
+        return sub_n_scalar(r + i, a + i, b + i, n - i, borrow);
+    }
+
+    __attribute__((target("avx2")))
+    static int cmp_n_avx2(const limb *a, const limb *b, std::size_t n) {
+        for (; n >= 4; n -= 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + n - 4));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + n - 4));
+            unsigned ne = lanes_avx2(_mm256_cmpeq_epi64(x, y)) ^ 0xF;
+            if (ne != 0) {
+                std::size_t i = n - 4 + 31 - __builtin_clz(ne);
+                return a[i] < b[i] ? -1 : 1;
+            }
+        }
+        return cmp_n_scalar(a, b, n);
+    }
+
+    __attribute__((target("avx2")))
+    static std::size_t normalized_size_avx2(const limb *a, std::size_t n) {
+        for (; n >= 4; n -= 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + n - 4));
+            unsigned nz = lanes_avx2(_mm256_cmpeq_epi64(v, _mm256_setzero_si256())) ^ 0xF;
+            if (nz != 0) { return n - 4 + 32 - __builtin_clz(nz); }
+        }
+        return normalized_size_scalar(a, n);
+    }
+
+#endif
+
+    struct Dispatch {
+        const char *name;
+        limb (*add_n)(limb *, const limb *, const limb *, std::size_t);
+        limb (*sub_n)(limb *, const limb *, const limb *, std::size_t);
+        int (*cmp_n)(const limb *, const limb *, std::size_t);
+        std::size_t (*normalized_size)(const limb *, std::size_t);
+    };
+
+    static const Dispatch &dispatch() {
+//        Picked once from the CPU, BIGINT_SIMD=scalar|avx2|avx512 can ask for a lower level.
+        static const Dispatch selected = [] {
+            const Dispatch scalar = {
+                    "scalar",
+                    [](limb *r, const limb *a, const limb *b, std::size_t n) { return add_n_scalar(r, a, b, n, 0); },
+                    [](limb *r, const limb *a, const limb *b, std::size_t n) { return sub_n_scalar(r, a, b, n, 0); },
+                    cmp_n_scalar, normalized_size_scalar
+            };
+#if defined(__x86_64__) || defined(__i386__)
+            const Dispatch avx2 = {"avx2", add_n_avx2, sub_n_avx2, cmp_n_avx2, normalized_size_avx2};
+            const Dispatch avx512 = {"avx512", add_n_avx512, sub_n_avx512, cmp_n_avx512, normalized_size_avx512};
+            const char *env = std::getenv("BIGINT_SIMD");
+            std::string_view want = env != nullptr ? env : "avx512";
+            __builtin_cpu_init();
+            if (want == "avx512" && __builtin_cpu_supports("avx512f")) { return avx512; }
+            if (want != "scalar" && __builtin_cpu_supports("avx2")) { return avx2; }
+#endif
+            return scalar;
+        }();
+        return selected;
+    }
+
+    const char *simd_level() {
+        return dispatch().name;
+    }
+
+    limb add_n(limb *r, const limb *a, const limb *b, std::size_t n) {
+        return dispatch().add_n(r, a, b, n);
+    }
+
+    limb add(limb *r, const limb *a, std::size_t an, const limb *b, std::size_t bn) {
+        limb carry = add_n(r, a, b, bn);
+        std::size_t i = bn;
+        for (; i < an && carry != 0; i++) {
+            r[i] = a[i] + 1;
+            carry = r[i] == 0 ? 1 : 0;
+        }
+//        Once the carry is absorbed the rest is a copy, or nothing at all in place.
+        if (r != a) { std::copy(a + i, a + an, r + i); }
+        return carry;
+    }
+
+    limb sub_n(limb *r, const limb *a, const limb *b, std::size_t n) {
+        return dispatch().sub_n(r, a, b, n);
+    }
+
+    limb sub(limb *r, const limb *a, std::size_t an, const limb *b, std::size_t bn) {
+        limb borrow = sub_n(r, a, b, bn);
+        std::size_t i = bn;
+        for (; i < an && borrow != 0; i++) {
+            borrow = a[i] == 0 ? 1 : 0;
+            r[i] = a[i] - 1;
+        }
+        if (r != a) { std::copy(a + i, a + an, r + i); }
+        return borrow;
+    }
+
+    limb addmul_1(limb *r, const limb *a, std::size_t n, limb b) {
+        limb carry = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            dlimb tmp = static_cast<dlimb>(a[i]) * b + r[i] + carry;
+            r[i] = static_cast<limb>(tmp);
+            carry = static_cast<limb>(tmp >> 64);
+        }
+        return carry;
+    }
+
+    limb submul_1(limb *r, const limb *a, std::size_t n, limb b) {
+        limb borrow = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            dlimb prod = static_cast<dlimb>(a[i]) * b + borrow;
+            limb low = static_cast<limb>(prod);
+            borrow = static_cast<limb>(prod >> 64) + (r[i] < low ? 1 : 0);
+            r[i] -= low;
+        }
+        return borrow;
+    }
+
+    limb mul_1(limb *r, const limb *a, std::size_t n, limb b) {
+        limb carry = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            dlimb tmp = static_cast<dlimb>(a[i]) * b + carry;
+            r[i] = static_cast<limb>(tmp);
+            carry = static_cast<limb>(tmp >> 64);
+        }
+        return carry;
+    }
+
+//    Division by a limb through its reciprocal (Moller and Granlund, "Improved division by invariant
+//    integers"): one 128 bit division up front, then two multiplications per limb instead of a
+//    128 by 64 bit division. The divisor is shifted to have its top bit set and the dividend is
+//    shifted along with it on the fly.
+    struct Reciprocal {
+        limb d;         // the normalized divisor
+        limb v;         // floor((2^128 - 1) / d) - 2^64
+        unsigned shift;
+
+        explicit Reciprocal(limb divisor) : shift(__builtin_clzll(divisor)) {
+            d = divisor << shift;
+            v = static_cast<limb>(~dlimb(0) / d);
+        }
+
+//        (u1, u0) / d with u1 < d, the quotient is returned and r gets the remainder.
+        limb divide(limb u1, limb u0, limb &r) const {
+            dlimb p = static_cast<dlimb>(v) * u1 + ((static_cast<dlimb>(u1) << 64) | u0);
+            limb q1 = static_cast<limb>(p >> 64) + 1, q0 = static_cast<limb>(p);
+            limb rem = u0 - q1 * d;
+            if (rem > q0) {
+                q1--;
+                rem += d;
+            }
+            if (rem >= d) {
+                q1++;
+                rem -= d;
+            }
+            r = rem;
+            return q1;
+        }
+    };
+
+    template<bool QUOTIENT>
+    static limb divide_1(limb *q, const limb *a, std::size_t n, limb divisor) {
+        const Reciprocal inv(divisor);
+        const unsigned s = inv.shift;
+        if (n == 0) { return 0; }
+        limb r = s != 0 ? a[n - 1] >> (64 - s) : 0;
+        for (std::size_t i = n; i-- > 0;) {
+            limb u0 = a[i] << s;
+            if (s != 0 && i > 0) { u0 |= a[i - 1] >> (64 - s); }
+            limb digit = inv.divide(r, u0, r);
+            if constexpr (QUOTIENT) { q[i] = digit; }
+        }
+        return r >> s;
+    }
+
+    limb divmod_1(limb *q, const limb *a, std::size_t n, limb d) {
+        return divide_1<true>(q, a, n, d);
+    }
+
+    limb mod_1(const limb *a, std::size_t n, limb d) {
+        return divide_1<false>(nullptr, a, n, d);
+    }
+
+    int cmp_n(const limb *a, const limb *b, std::size_t n) {
+        return dispatch().cmp_n(a, b, n);
+    }
+
+    std::size_t normalized_size(const limb *a, std::size_t n) {
+        return dispatch().normalized_size(a, n);
+    }
+
+    void mul_basecase(limb *out, const limb *a, std::size_t n, const limb *b, std::size_t m) {
+        for (std::size_t i = 0; i < n + m; i++) { out[i] = 0; }
+        for (std::size_t j = 0; j < m; j++) {
+            out[n + j] = addmul_1(out + j, a, n, b[j]);
+        }
+    }
+
+    void sqr_basecase(limb *out, const limb *a, std::size_t n) {
+        for (std::size_t i = 0; i < 2 * n; i++) { out[i] = 0; }
+//        Cross products a[i] * a[j] with i < j, then doubled.
+        for (std::size_t i = 0; i + 1 < n; i++) {
+            out[i + n] = addmul_1(out + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+        }
+        limb high = 0;
+        for (std::size_t i = 0; i < 2 * n; i++) {
+            limb next = out[i] >> 63;
+            out[i] = (out[i] << 1) | high;
+            high = next;
+        }
+//        Diagonal squares.
+        limb carry = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            dlimb sq = static_cast<dlimb>(a[i]) * a[i];
+            dlimb low = static_cast<dlimb>(out[2 * i]) + static_cast<limb>(sq) + carry;
+            out[2 * i] = static_cast<limb>(low);
+            dlimb up = static_cast<dlimb>(out[2 * i + 1]) + static_cast<limb>(sq >> 64) + static_cast<limb>(low >> 64);
+            out[2 * i + 1] = static_cast<limb>(up);
+            carry = static_cast<limb>(up >> 64);
+        }
+    }
+}
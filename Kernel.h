@@ -0,0 +1,70 @@
+//
+//@brief: Definitions for the limb kernels shared by the BigInt algorithms.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_KERNEL_H
+#define BIGINT_KERNEL_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kernel {
+    /**
+     *  Loops over raw limb arrays (base 2^64, least significant limb first). Lengths are in limbs,
+     * the result may alias an input of the same offset unless stated otherwise.
+     *  add_n, sub_n, cmp_n and normalized_size run on AVX-512 or AVX2 when the CPU has them, picked
+     * once at the first call, with a portable fallback.
+     */
+    typedef std::uint64_t limb;
+
+//    r[0..n) = a[0..n) + b[0..n), return the carry.
+    limb add_n(limb *r, const limb *a, const limb *b, std::size_t n);
+
+//    r[0..an) = a[0..an) + b[0..bn) with an >= bn, return the carry.
+    limb add(limb *r, const limb *a, std::size_t an, const limb *b, std::size_t bn);
+
+//    r[0..n) = a[0..n) - b[0..n), return the borrow.
+    limb sub_n(limb *r, const limb *a, const limb *b, std::size_t n);
+
+//    r[0..an) = a[0..an) - b[0..bn) with an >= bn, return the borrow.
+    limb sub(limb *r, const limb *a, std::size_t an, const limb *b, std::size_t bn);
+
+//    r[0..n) = a[0..n) * b, return the carry limb.
+    limb mul_1(limb *r, const limb *a, std::size_t n, limb b);
+
+//    r[0..n) += a[0..n) * b, return the carry limb.
+    limb addmul_1(limb *r, const limb *a, std::size_t n, limb b);
+
+//    r[0..n) -= a[0..n) * b, return the borrow limb.
+    limb submul_1(limb *r, const limb *a, std::size_t n, limb b);
+
+//    q[0..n) = a[0..n) / d, return the remainder, q may alias a.
+    limb divmod_1(limb *q, const limb *a, std::size_t n, limb d);
+
+//    a[0..n) % d without the quotient.
+    limb mod_1(const limb *a, std::size_t n, limb d);
+
+//    compare a[0..n) with b[0..n), return -1, 0 or 1.
+    int cmp_n(const limb *a, const limb *b, std::size_t n);
+
+//    length of a[0..n) without its leading zero limbs.
+    std::size_t normalized_size(const limb *a, std::size_t n);
+
+//    the instruction set picked for add_n, sub_n, cmp_n and normalized_size: "avx512", "avx2" or "scalar".
+    const char *simd_level();
+
+//    out[0..n+m) = a[0..n) * b[0..m) by the schoolbook method, out must not alias a or b.
+    void mul_basecase(limb *out, const limb *a, std::size_t n, const limb *b, std::size_t m);
+
+//    out[0..2n) = a[0..n)^2, computing every cross product once, out must not alias a.
+    void sqr_basecase(limb *out, const limb *a, std::size_t n);
+}
+
+
+#endif //BIGINT_KERNEL_H
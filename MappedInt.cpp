@@ -0,0 +1,403 @@
+//
+//@brief: Implementations of MappedInt, the out-of-core arithmetic on memory-mapped files.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "MappedInt.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Kernel.h"
+#include "Multiply.h"
+#include "Stats.h"
+
+typedef MappedInt::limb limb;
+
+struct MappedInt::Header {
+    std::uint64_t magic;
+    std::uint64_t count;        // limbs of the magnitude
+    std::uint64_t negative;
+    std::uint64_t reserved[5];
+};
+
+const std::uint64_t MAGIC = 0x31746e4970614d42;     // "BMapInt1"
+const std::size_t HEADER_BYTES = 64;
+const std::size_t BLOCK_LIMBS = 1 << 17;            // limbs of each operand a sum works on at a time, 1 MiB
+
+static std::atomic<std::size_t> segment(1 << 22);   // 32 MiB segments of a product
+
+//let the kernel drop the whole pages of p[0..n) from this process, the file keeps their contents.
+static void release(const void *p, std::size_t n) {
+    const std::uintptr_t page = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    std::uintptr_t begin = (reinterpret_cast<std::uintptr_t>(p) + page - 1) / page * page;
+    std::uintptr_t end = (reinterpret_cast<std::uintptr_t>(p) + n) / page * page;
+    if (begin < end) { madvise(reinterpret_cast<void *>(begin), end - begin, MADV_DONTNEED); }
+}
+
+//r[0..n) += p[0..len) * 2^(64 * off) modulo 2^(64 * n), the carry runs on as far as it has to.
+static void add_at(limb *r, std::size_t n, std::size_t off, const limb *p, std::size_t len) {
+    if (off >= n) { return; }
+    len = std::min(len, n - off);
+    limb carry = kernel::add_n(r + off, r + off, p, len);
+    if (carry != 0 && off + len < n) { kernel::add(r + off + len, r + off + len, n - off - len, &carry, 1); }
+}
+
+//r[0..n) -= p[0..len) * 2^(64 * off) modulo 2^(64 * n).
+static void sub_at(limb *r, std::size_t n, std::size_t off, const limb *p, std::size_t len) {
+    if (off >= n) { return; }
+    len = std::min(len, n - off);
+    limb borrow = kernel::sub_n(r + off, r + off, p, len);
+    if (borrow != 0 && off + len < n) { kernel::sub(r + off + len, r + off + len, n - off - len, &borrow, 1); }
+}
+
+//the directory a file at path goes to, where its temporary files go too.
+static std::string directory_of(const std::string &path) {
+    const std::size_t slash = path.rfind('/');
+    if (slash == std::string::npos) { return "."; }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+//a new file of its own in dir, open for writing; name holds its path.
+static int temporary(const std::string &dir, std::string &name) {
+    std::vector<char> pattern(dir.begin(), dir.end());
+    const char suffix[] = "/.bigint-XXXXXX";
+    pattern.insert(pattern.end(), suffix, suffix + sizeof(suffix));
+    const int fd = mkstemp(pattern.data());
+    if (fd < 0) { throw "Can't open the file."; }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    name = pattern.data();
+    return fd;
+}
+
+//n zero limbs of scratch for a product in an unlinked file of dir, so like the operands it lives in
+//the page cache while in use and on disk otherwise, and leaves nothing behind.
+struct Spill {
+    int fd;
+    limb *data = nullptr;
+    std::size_t bytes;
+
+    Spill(const std::string &dir, std::size_t n) : bytes(std::max<std::size_t>(n, 1) * sizeof(limb)) {
+        std::string name;
+        fd = temporary(dir, name);
+        unlink(name.c_str());
+        void *p = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+            p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (p == MAP_FAILED) {
+            close(fd);
+            throw "Can't map the file.";
+        }
+        data = static_cast<limb *>(p);
+    }
+
+    ~Spill() {
+        munmap(data, bytes);
+        close(fd);
+    }
+
+    Spill(const Spill &) = delete;
+
+    Spill &operator=(const Spill &) = delete;
+};
+
+//r[0..rn) += x[0..n) * y[0..m) modulo 2^(64 * rn). Once the shorter factor fits a segment the longer
+//one is run past it segment by segment in memory, with product holding one result; longer factors are
+//split Karatsuba style, with the sums of the halves and the three products of them in spill files.
+static void multiply_segments(limb *r, std::size_t rn, const limb *x, std::size_t n, const limb *y, std::size_t m,
+                              std::size_t s, const std::string &dir, limb *product) {
+    if (n < m) {
+        std::swap(x, y);
+        std::swap(n, m);
+    }
+    if (m == 0) { return; }
+    if (m <= s) {
+        for (std::size_t i = 0; i < n; i += s) {
+            const std::size_t la = std::min(s, n - i);
+            multiply_limbs(product, x + i, la, y, m);
+            add_at(r, rn, i, product, la + m);
+            if (x != y) { release(x + i, la * sizeof(limb)); }
+        }
+        return;
+    }
+    if (n >= 2 * m) {
+        for (std::size_t i = 0; i < n; i += m) {
+            multiply_segments(r + i, rn - i, x + i, std::min(m, n - i), y, m, s, dir, product);
+        }
+        return;
+    }
+
+//    x = x1 B + x0 and y = y1 B + y0 with B = 2^(64 h): the product is z0 + z1 B + z2 B^2 where
+//    z1 = (x0 + x1)(y0 + y1) - z0 - z2. Sums and differences wrap modulo 2^(64 rn), which cancels out
+//    since the final value fits, so the terms go in as soon as they are ready, in any order.
+    const std::size_t h = (m + 1) / 2, hx = n - h, hy = m - h;
+    const bool square = x == y && n == m;
+    {
+        const std::size_t lx = std::max(h, hx) + 1, ly = h + 1;
+        Spill sums(dir, square ? lx : lx + ly);
+        limb *sx = sums.data, *sy = square ? sx : sx + lx;
+        sx[lx - 1] = hx >= h ? kernel::add(sx, x + h, hx, x, h) : kernel::add(sx, x, h, x + h, hx);
+        if (!square) { sy[ly - 1] = kernel::add(sy, y, h, y + h, hy); }
+        Spill mid(dir, lx + ly);
+        multiply_segments(mid.data, lx + ly, sx, lx, sy, square ? lx : ly, s, dir, product);
+        add_at(r, rn, h, mid.data, lx + ly);
+    }
+    {
+        Spill low(dir, 2 * h);
+        multiply_segments(low.data, 2 * h, x, h, y, h, s, dir, product);
+        add_at(r, rn, 0, low.data, 2 * h);
+        sub_at(r, rn, h, low.data, 2 * h);
+    }
+    {
+        Spill high(dir, hx + hy);
+        multiply_segments(high.data, hx + hy, x + h, hx, y + h, hy, s, dir, product);
+        add_at(r, rn, 2 * h, high.data, hx + hy);
+        sub_at(r, rn, h, high.data, hx + hy);
+    }
+}
+
+MappedInt::MappedInt(MappedInt &&x) noexcept
+        : fd(x.fd), base(x.base), bytes(x.bytes), device(x.device), inode(x.inode),
+          temp(std::move(x.temp)), target(std::move(x.target)) {
+    x.fd = -1;
+    x.base = nullptr;
+    x.bytes = 0;
+    x.temp.clear();
+}
+
+MappedInt &MappedInt::operator=(MappedInt &&x) noexcept {
+    if (this != &x) {
+        this->discard();
+        this->fd = x.fd;
+        this->base = x.base;
+        this->bytes = x.bytes;
+        this->device = x.device;
+        this->inode = x.inode;
+        this->temp = std::move(x.temp);
+        this->target = std::move(x.target);
+        x.fd = -1;
+        x.base = nullptr;
+        x.bytes = 0;
+        x.temp.clear();
+    }
+    return *this;
+}
+
+MappedInt::~MappedInt() {
+    this->discard();
+}
+
+MappedInt MappedInt::open(const std::string &path) {
+//    Map a file written by store() or by an operation, read only.
+    MappedInt x;
+    x.fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (x.fd < 0) { throw "Can't open the file."; }
+    x.identify();
+    struct stat st{};
+    if (fstat(x.fd, &st) != 0) { throw "Can't open the file."; }
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (size < HEADER_BYTES) { throw "Not a mapped BigInt file."; }
+    x.map(size, false);
+    const Header *h = x.header();
+    if (h->magic != MAGIC || h->count > (size - HEADER_BYTES) / sizeof(limb)) { throw "Not a mapped BigInt file."; }
+    return x;
+}
+
+MappedInt MappedInt::store(const std::string &path, const BigInt &x) {
+//    Write x to a new file at path.
+    MappedInt r = create(path, x.limbs.size());
+    std::copy_n(x.limbs.data(), x.limbs.size(), r.limbs());
+    r.finish(x.limbs.size(), x.negative);
+    return r;
+}
+
+BigInt MappedInt::load() const {
+//    The number back in memory.
+    BigInt x;
+    x.limbs.resize_for_overwrite(this->size());
+    std::copy_n(this->data(), this->size(), x.limbs.data());
+    x.negative = this->is_negative();
+    x.normalize();
+    return x;
+}
+
+std::size_t MappedInt::size() const {
+//    Number of limbs.
+    return static_cast<std::size_t>(this->header()->count);
+}
+
+bool MappedInt::is_negative() const {
+    return this->header()->negative != 0;
+}
+
+const limb *MappedInt::data() const {
+    return this->limbs();
+}
+
+MappedInt MappedInt::add(const MappedInt &a, const MappedInt &b, const std::string &path) {
+    BIGINT_STAT_OP(Add, std::max(a.size(), b.size()));
+    return linear(a, b, false, path);
+}
+
+MappedInt MappedInt::sub(const MappedInt &a, const MappedInt &b, const std::string &path) {
+    BIGINT_STAT_OP(Sub, std::max(a.size(), b.size()));
+    return linear(a, b, true, path);
+}
+
+MappedInt MappedInt::multiply(const MappedInt &a, const MappedInt &b, const std::string &path) {
+//    Karatsuba over the files down to products of segments, which go through the in-memory tiers.
+    const std::size_t n = a.size(), m = b.size();
+    BIGINT_STAT_OP(Mul, std::max(n, m));
+    MappedInt r = create(path, n + m);
+    const bool square = a.device == b.device && a.inode == b.inode && n == m;
+    const limb *x = a.data(), *y = square ? x : b.data();
+//    Halving shrinks a factor only from 4 limbs up, so shorter segments act as 3 limbs.
+    const std::size_t s = std::max<std::size_t>(segment_limbs(), 3);
+    Limbs product;
+    product.resize_for_overwrite(2 * std::min(s, std::max(n, m)));
+    multiply_segments(r.limbs(), n + m, x, n, y, m, s, directory_of(path), product.data());
+    r.finish(n + m, a.is_negative() != b.is_negative());
+    return r;
+}
+
+void MappedInt::set_segment_limbs(std::size_t limbs) {
+//    Length of the segments a product is cut into, 2^22 limbs (32 MiB) by default. A product holds
+//    two segments' worth of limbs in memory besides what its tier needs for one pair, and about twice
+//    the length of the operands in temporary files next to the result.
+    segment.store(std::max<std::size_t>(limbs, 1), std::memory_order_relaxed);
+}
+
+std::size_t MappedInt::segment_limbs() {
+    return segment.load(std::memory_order_relaxed);
+}
+
+//a new file with room for n limbs, all zero. It is written under a temporary name next to path and
+//only takes the place of path in finish(), so mappings of a file already at path keep their contents.
+MappedInt MappedInt::create(const std::string &path, std::size_t n) {
+    MappedInt r;
+    r.fd = temporary(directory_of(path), r.temp);
+    r.target = path;
+    r.identify();
+    const std::size_t size = HEADER_BYTES + n * sizeof(limb);
+    if (ftruncate(r.fd, static_cast<off_t>(size)) != 0) { throw "Can't resize the file."; }
+    r.map(size, true);
+    r.header()->magic = MAGIC;
+    return r;
+}
+
+MappedInt::Header *MappedInt::header() const {
+    static_assert(sizeof(Header) == HEADER_BYTES, "The limbs start on a cache line of their own.");
+    return static_cast<Header *>(this->base);
+}
+
+limb *MappedInt::limbs() const {
+    return reinterpret_cast<limb *>(static_cast<char *>(this->base) + HEADER_BYTES);
+}
+
+void MappedInt::identify() {
+    struct stat st{};
+    if (fstat(this->fd, &st) != 0) { throw "Can't open the file."; }
+    this->device = static_cast<std::uint64_t>(st.st_dev);
+    this->inode = static_cast<std::uint64_t>(st.st_ino);
+}
+
+void MappedInt::map(std::size_t size, bool write) {
+    void *p = mmap(nullptr, size, PROT_READ | (write ? PROT_WRITE : 0), MAP_SHARED, this->fd, 0);
+    if (p == MAP_FAILED) { throw "Can't map the file."; }
+    this->base = p;
+    this->bytes = size;
+}
+
+void MappedInt::unmap() {
+    if (this->base != nullptr) { munmap(this->base, this->bytes); }
+    this->base = nullptr;
+    this->bytes = 0;
+}
+
+//let go of the file, removing it if an operation failed before finish() moved it into place.
+void MappedInt::discard() {
+    this->unmap();
+    if (this->fd >= 0) { close(this->fd); }
+    if (!this->temp.empty()) { unlink(this->temp.c_str()); }
+    this->fd = -1;
+    this->temp.clear();
+}
+
+//record the result of n limbs (leading zeros allowed) with its sign, cut the file to its length and
+//move it to the path it was created for.
+void MappedInt::finish(std::size_t n, bool negative) {
+    n = kernel::normalized_size(this->limbs(), n);
+    Header *h = this->header();
+    h->count = n;
+    h->negative = negative && n > 0 ? 1 : 0;
+    const std::size_t size = HEADER_BYTES + n * sizeof(limb);
+    if (size < this->bytes) {
+        this->unmap();
+        if (ftruncate(this->fd, static_cast<off_t>(size)) != 0) { throw "Can't resize the file."; }
+        this->map(size, true);
+    }
+    if (rename(this->temp.c_str(), this->target.c_str()) != 0) { throw "Can't write the file."; }
+    this->temp.clear();
+}
+
+//a + b, or a - b when subtract is set, a block at a time.
+MappedInt MappedInt::linear(const MappedInt &a, const MappedInt &b, bool subtract, const std::string &path) {
+    const bool aneg = a.is_negative(), bneg = b.is_negative() != subtract;
+//    Magnitudes: |x| >= |y| with x first, found from the top limbs down when the signs differ.
+    const MappedInt *x = &a, *y = &b;
+    bool negative = aneg;
+    int c = a.size() != b.size() ? (a.size() < b.size() ? -1 : 1) : 0;
+    if (c == 0 && aneg != bneg) {
+        for (std::size_t top = a.size(); top > 0 && c == 0;) {
+            const std::size_t k = std::min(BLOCK_LIMBS, top);
+            top -= k;
+            c = kernel::cmp_n(a.data() + top, b.data() + top, k);
+        }
+    }
+    if (c < 0) {
+        std::swap(x, y);
+        negative = bneg;
+    }
+    const std::size_t n = x->size(), m = y->size();
+    const bool same = aneg == bneg;
+    MappedInt r = create(path, n + 1);
+    if (!same && c == 0) {
+        r.finish(0, false);
+        return r;
+    }
+
+    const limb *xp = x->data(), *yp = y->data();
+    limb *out = r.limbs();
+    limb carry = 0;
+    for (std::size_t off = 0; off < n; off += BLOCK_LIMBS) {
+//        The carry or borrow out of the block below goes in as a one limb operand.
+        const std::size_t k = std::min(BLOCK_LIMBS, n - off), ky = off < m ? std::min(k, m - off) : 0;
+        limb next;
+        if (same) {
+            next = ky > 0 ? kernel::add(out + off, xp + off, k, yp + off, ky) : 0;
+            if (ky == 0) { std::copy_n(xp + off, k, out + off); }
+            if (carry != 0) { next += kernel::add(out + off, out + off, k, &carry, 1); }
+        } else {
+            next = ky > 0 ? kernel::sub(out + off, xp + off, k, yp + off, ky) : 0;
+            if (ky == 0) { std::copy_n(xp + off, k, out + off); }
+            if (carry != 0) { next += kernel::sub(out + off, out + off, k, &carry, 1); }
+        }
+        carry = next;
+        release(xp + off, k * sizeof(limb));
+        if (ky > 0) { release(yp + off, ky * sizeof(limb)); }
+    }
+    out[n] = same ? carry : 0;
+    r.finish(n + 1, negative);
+    return r;
+}
@@ -0,0 +1,105 @@
+//
+//@brief: Definitions for MappedInt, a BigInt kept in a memory-mapped file.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_MAPPEDINT_H
+#define BIGINT_MAPPEDINT_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "BigInt.h"
+
+class MappedInt {
+    /**
+     *  A number too large to keep in memory comfortably: the limbs live in a file that is mapped into
+     * the address space, so the page cache holds what is in use and the rest stays on disk. The file
+     * is a 64 byte header (magic, limb count, sign) followed by the magnitude as limbs in the byte
+     * order of the host, least significant first, which the kernels use in place.
+     *  add(), sub() and multiply() read their operands through the mappings and write a new file.
+     * Sums and differences run in blocks of limbs with the carry handed from block to block, and
+     * pages behind the pass are released as it goes. Products run Karatsuba over the files, keeping
+     * the sums and partial products of the halves in unlinked temporary files next to the result,
+     * down to factors of segment_limbs() limbs, which are multiplied in memory through the usual tiers
+     * (the transform for long segments). So memory use is a few segments whatever the size of the
+     * operands, and a product of k segments a side costs about k^1.58 segment products, not k^2.
+     *  Results are written under a temporary name and renamed to their path when complete, so a
+     * result may replace an operand's file, or one other MappedInts still map, without disturbing
+     * them. Needs a POSIX system.
+     */
+public:
+    typedef BigInt::limb limb;
+
+    MappedInt(MappedInt &&) noexcept;
+
+    MappedInt &operator=(MappedInt &&) noexcept;
+
+    MappedInt(const MappedInt &) = delete;
+
+    MappedInt &operator=(const MappedInt &) = delete;
+
+    ~MappedInt();
+
+    static MappedInt open(const std::string &);
+
+    static MappedInt store(const std::string &, const BigInt &);
+
+    BigInt load() const;
+
+    std::size_t size() const;
+
+    bool is_negative() const;
+
+    const limb *data() const;
+
+    static MappedInt add(const MappedInt &, const MappedInt &, const std::string &);
+
+    static MappedInt sub(const MappedInt &, const MappedInt &, const std::string &);
+
+    static MappedInt multiply(const MappedInt &, const MappedInt &, const std::string &);
+
+    static void set_segment_limbs(std::size_t);
+
+    static std::size_t segment_limbs();
+
+private:
+    struct Header;
+
+    int fd = -1;                // the open file
+    void *base = nullptr;       // its mapping, header first
+    std::size_t bytes = 0;      // length of the mapping
+    std::uint64_t device = 0;   // identity of the file, to tell a square
+    std::uint64_t inode = 0;
+    std::string temp;           // name of a result while it is written, empty once it is in place
+    std::string target;         // the path it moves to
+
+private:
+    MappedInt() = default;
+
+    static MappedInt create(const std::string &, std::size_t);
+
+    Header *header() const;
+
+    limb *limbs() const;
+
+    void identify();
+
+    void map(std::size_t, bool);
+
+    void unmap();
+
+    void discard();
+
+    void finish(std::size_t, bool);
+
+    static MappedInt linear(const MappedInt &, const MappedInt &, bool, const std::string &);
+};
+
+
+#endif //BIGINT_MAPPEDINT_H
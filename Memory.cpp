@@ -0,0 +1,172 @@
+//
+//@brief: Implementations of the limb storage allocators used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Memory.h"
+#include "BigInt.h"
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+namespace memory {
+    const unsigned MIN_CLASS_BITS = 5;                  // 32 bytes, four limbs
+    const unsigned MAX_CLASS_BITS = 20;                 // 1 MiB, larger blocks are not pooled
+    const unsigned CLASSES = MAX_CLASS_BITS - MIN_CLASS_BITS + 1;
+    const std::size_t CLASS_CACHE_BYTES = 1 << 20;      // bytes a thread keeps per class
+    const std::size_t MAX_CHUNKS = 48;
+    const std::size_t MIN_CHUNK = 1 << 16;
+    const std::size_t ARENA_KEEP = 4 << 20;             // arena bytes a thread keeps between frames
+
+    static void *default_allocate(std::size_t n) {
+        return ::operator new(n);
+    }
+
+    static void default_deallocate(void *p, std::size_t) {
+        ::operator delete(p);
+    }
+
+    static std::atomic<AllocateFn> allocate_hook(default_allocate);
+    static std::atomic<DeallocateFn> deallocate_hook(default_deallocate);
+
+//    Both per thread states are trivially destructible, so they stay readable while other
+//    thread_local objects are destroyed; the guards below hand their memory back at thread exit.
+    struct Block {
+        Block *next;
+    };
+
+    struct Cache {
+        Block *head[CLASSES];
+        std::size_t count[CLASSES];
+        bool dead;
+    };
+
+    struct Chunk {
+        char *data;
+        std::size_t size;
+    };
+
+    struct Arena {
+        Chunk chunks[MAX_CHUNKS];
+        std::size_t count;
+        std::size_t current;
+        std::size_t offset;
+        std::size_t depth;
+    };
+
+    static thread_local Cache cache;
+    static thread_local Arena arena;
+
+    static void release_chunks(std::size_t from) {
+        for (std::size_t i = from; i < arena.count; i++) {
+            deallocate_hook.load(std::memory_order_relaxed)(arena.chunks[i].data, arena.chunks[i].size);
+        }
+        arena.count = std::min(arena.count, from);
+    }
+
+    struct Guard {
+        ~Guard() {
+            for (unsigned c = 0; c < CLASSES; c++) {
+                while (Block *b = cache.head[c]) {
+                    cache.head[c] = b->next;
+                    deallocate_hook.load(std::memory_order_relaxed)(b, std::size_t(1) << (c + MIN_CLASS_BITS));
+                }
+            }
+            cache.dead = true;
+            release_chunks(0);
+        }
+
+        void arm() {}
+    };
+
+    static thread_local Guard guard;
+
+    static unsigned class_of(std::size_t bytes) {
+        unsigned bits = bytes <= (std::size_t(1) << MIN_CLASS_BITS) ? MIN_CLASS_BITS : 64 - __builtin_clzll(bytes - 1);
+        return bits - MIN_CLASS_BITS;
+    }
+
+    void *allocate(std::size_t bytes) {
+        if (bytes > (std::size_t(1) << MAX_CLASS_BITS)) { return allocate_hook.load(std::memory_order_relaxed)(bytes); }
+        unsigned c = class_of(bytes);
+        if (Block *b = cache.head[c]) {
+            cache.head[c] = b->next;
+            cache.count[c]--;
+            return b;
+        }
+        return allocate_hook.load(std::memory_order_relaxed)(std::size_t(1) << (c + MIN_CLASS_BITS));
+    }
+
+    void deallocate(void *p, std::size_t bytes) {
+        if (bytes > (std::size_t(1) << MAX_CLASS_BITS)) {
+            deallocate_hook.load(std::memory_order_relaxed)(p, bytes);
+            return;
+        }
+        unsigned c = class_of(bytes);
+        std::size_t size = std::size_t(1) << (c + MIN_CLASS_BITS);
+        if (cache.dead || cache.count[c] >= std::max<std::size_t>(CLASS_CACHE_BYTES / size, 4)) {
+            deallocate_hook.load(std::memory_order_relaxed)(p, size);
+            return;
+        }
+        guard.arm();
+        Block *b = static_cast<Block *>(p);
+        b->next = cache.head[c];
+        cache.head[c] = b;
+        cache.count[c]++;
+    }
+
+    Scratch::Scratch() : chunk(arena.current), offset(arena.offset) {
+        arena.depth++;
+    }
+
+    Scratch::~Scratch() {
+        arena.current = chunk;
+        arena.offset = offset;
+        if (--arena.depth != 0) { return; }
+//        Back at the outermost frame: merge a grown arena into one chunk, or drop it when large.
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < arena.count; i++) { total += arena.chunks[i].size; }
+        if (arena.count > 1 || total > ARENA_KEEP) {
+            release_chunks(0);
+            if (total <= ARENA_KEEP) {
+                arena.chunks[0] = {static_cast<char *>(allocate_hook.load(std::memory_order_relaxed)(total)), total};
+                arena.count = 1;
+            }
+        }
+        arena.current = 0;
+        arena.offset = 0;
+    }
+
+    void *Scratch::take_bytes(std::size_t bytes) {
+        bytes = (bytes + 63) & ~std::size_t(63);
+        while (arena.current >= arena.count || arena.offset + bytes > arena.chunks[arena.current].size) {
+//            Move on to the next chunk, every chunk past the current one is free.
+            std::size_t next = arena.current < arena.count ? arena.current + 1 : arena.current;
+            if (next < arena.count && arena.chunks[next].size < bytes) { release_chunks(next); }
+            if (next == arena.count) {
+                if (arena.count == MAX_CHUNKS) { throw std::bad_alloc(); }
+                guard.arm();
+                std::size_t size = std::max({bytes, MIN_CHUNK, next > 0 ? 2 * arena.chunks[next - 1].size : 0});
+                arena.chunks[next] = {static_cast<char *>(allocate_hook.load(std::memory_order_relaxed)(size)), size};
+                arena.count++;
+            }
+            arena.current = next;
+            arena.offset = 0;
+        }
+        void *p = arena.chunks[arena.current].data + arena.offset;
+        arena.offset += bytes;
+        return p;
+    }
+}
+
+void BigInt::set_allocator(memory::AllocateFn allocate, memory::DeallocateFn deallocate) {
+//    Install it before the first BigInt is built: blocks are handed back to the allocator in force
+//    when they are freed. Null restores ::operator new and delete.
+    memory::allocate_hook.store(allocate != nullptr ? allocate : memory::default_allocate, std::memory_order_relaxed);
+    memory::deallocate_hook.store(deallocate != nullptr ? deallocate : memory::default_deallocate,
+                                  std::memory_order_relaxed);
+}
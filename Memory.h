@@ -0,0 +1,278 @@
+//
+//@brief: Definitions for the limb storage allocators used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_MEMORY_H
+#define BIGINT_MEMORY_H
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace memory {
+    /**
+     *  Two layers between the arithmetic and the heap.
+     *  allocate()/deallocate() pool blocks by power of two size classes in a cache per thread, so
+     * the limb vectors of results and of the Nat temporaries of division, conversion and Toom-Cook
+     * reuse freed blocks instead of calling the heap once the program has warmed up. Blocks above
+     * the largest class, and the misses, go to the allocator set by BigInt::set_allocator().
+     *  Scratch is a frame of the bump arena of the calling thread: take() hands out uninitialized
+     * buffers that all go back at once when the frame ends, which is how the multiplication tiers
+     * get their scratch. Frames nest like the calls that open them and must end on their thread.
+     */
+    typedef void *(*AllocateFn)(std::size_t);
+    typedef void (*DeallocateFn)(void *, std::size_t);
+
+    void *allocate(std::size_t);
+
+    void deallocate(void *, std::size_t);
+
+    template<class T>
+    struct PoolAllocator {
+        typedef T value_type;
+
+        PoolAllocator() = default;
+
+        template<class U>
+        PoolAllocator(const PoolAllocator<U> &) {}
+
+        T *allocate(std::size_t n) { return static_cast<T *>(memory::allocate(n * sizeof(T))); }
+
+        void deallocate(T *p, std::size_t n) { memory::deallocate(p, n * sizeof(T)); }
+
+        template<class U>
+        bool operator==(const PoolAllocator<U> &) const { return true; }
+    };
+
+    class Scratch {
+        std::size_t chunk;      // where the arena stood when the frame began
+        std::size_t offset;
+
+    public:
+        Scratch();
+
+        ~Scratch();
+
+        Scratch(const Scratch &) = delete;
+
+        Scratch &operator=(const Scratch &) = delete;
+
+        template<class T>
+        T *take(std::size_t n) { return static_cast<T *>(take_bytes(n * sizeof(T))); }
+
+    private:
+        void *take_bytes(std::size_t);
+    };
+}
+
+template<std::size_t N>
+class LimbVector {
+    /**
+     *  The limb storage of BigInt: a vector of limbs that keeps up to N of them inside the object
+     * and moves to a block of the size class pools once it grows past that, so word sized values
+     * (counters, small constants, the one of ++) never touch the heap.
+     *  It has the subset of the std::vector interface the arithmetic uses, with plain pointers as
+     * iterators. New limbs from resize() and the sized constructor are zero, as with std::vector;
+     * clear() and shrinking keep the capacity.
+     */
+    static_assert(N >= 1, "The inline buffer has to hold the heap pointer.");
+
+public:
+    typedef std::uint64_t value_type;
+    typedef std::uint64_t *iterator;
+    typedef const std::uint64_t *const_iterator;
+
+    LimbVector() noexcept {}
+
+    explicit LimbVector(std::size_t n) { resize(n); }
+
+    LimbVector(std::size_t n, value_type v) { assign(n, v); }
+
+    template<class It>
+    requires (!std::is_integral_v<It>)
+    LimbVector(It first, It last) { assign(first, last); }
+
+    LimbVector(const LimbVector &x) {
+        grow(x.count);
+        std::copy_n(x.data(), x.count, data());
+        count = x.count;
+    }
+
+    LimbVector(LimbVector &&x) noexcept { steal(x); }
+
+    ~LimbVector() { release(); }
+
+    LimbVector &operator=(const LimbVector &x) {
+        if (this != &x) {
+            count = 0;
+            grow(x.count);
+            std::copy_n(x.data(), x.count, data());
+            count = x.count;
+        }
+        return *this;
+    }
+
+    LimbVector &operator=(LimbVector &&x) noexcept {
+        if (this != &x) {
+            release();
+            steal(x);
+        }
+        return *this;
+    }
+
+    std::size_t size() const { return count; }
+
+    std::size_t capacity() const { return cap; }
+
+    bool empty() const { return count == 0; }
+
+    value_type *data() { return cap == N ? local : heap; }
+
+    const value_type *data() const { return cap == N ? local : heap; }
+
+    value_type &operator[](std::size_t i) { return data()[i]; }
+
+    const value_type &operator[](std::size_t i) const { return data()[i]; }
+
+    value_type &front() { return data()[0]; }
+
+    const value_type &front() const { return data()[0]; }
+
+    value_type &back() { return data()[count - 1]; }
+
+    const value_type &back() const { return data()[count - 1]; }
+
+    iterator begin() { return data(); }
+
+    iterator end() { return data() + count; }
+
+    const_iterator begin() const { return data(); }
+
+    const_iterator end() const { return data() + count; }
+
+    void reserve(std::size_t n) {
+        if (n > cap) { reallocate(n); }
+    }
+
+    void resize(std::size_t n) { resize(n, 0); }
+
+    void resize(std::size_t n, value_type v) {
+        if (n > count) {
+            grow(n);
+            std::fill(data() + count, data() + n, v);
+        }
+        count = n;
+    }
+
+    void resize_for_overwrite(std::size_t n) {
+//        n limbs left as they are, the old ones are not kept either: for a caller about to write them all.
+        count = 0;
+        grow(n);
+        count = n;
+    }
+
+    void assign(std::size_t n, value_type v) {
+        count = 0;
+        resize(n, v);
+    }
+
+    template<class It>
+    requires (!std::is_integral_v<It>)
+    void assign(It first, It last) {
+        std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+        count = 0;
+        grow(n);
+        std::copy(first, last, data());
+        count = n;
+    }
+
+    void push_back(value_type v) {
+        if (count == cap) { grow(count + 1); }
+        data()[count++] = v;
+    }
+
+    void pop_back() { count--; }
+
+    void clear() { count = 0; }
+
+    iterator insert(const_iterator pos, std::size_t n, value_type v) {
+        std::size_t at = static_cast<std::size_t>(pos - data());
+        grow(count + n);
+        value_type *p = data();
+        std::memmove(p + at + n, p + at, (count - at) * sizeof(value_type));
+        std::fill(p + at, p + at + n, v);
+        count += n;
+        return p + at;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        value_type *p = data();
+        std::size_t at = static_cast<std::size_t>(first - p), n = static_cast<std::size_t>(last - first);
+        std::memmove(p + at, p + at + n, (count - at - n) * sizeof(value_type));
+        count -= n;
+        return p + at;
+    }
+
+    void swap(LimbVector &x) noexcept {
+//        No member points into the object itself, so swapping the bytes swaps the contents.
+        std::swap(count, x.count);
+        std::swap(cap, x.cap);
+        std::swap(local, x.local);
+    }
+
+private:
+    union {
+        value_type local[N] = {};   // the limbs while cap == N
+        value_type *heap;           // a block of cap limbs from memory::allocate() otherwise
+    };
+    std::size_t count = 0;
+    std::size_t cap = N;
+
+private:
+    void grow(std::size_t n) {
+//        Doubling keeps push_back amortized constant, pooled blocks are filled up to their class.
+        if (n <= cap) { return; }
+        n = std::max(n, 2 * cap);
+        if (n * sizeof(value_type) <= MAX_POOLED_BYTES) { n = std::size_t(1) << (64 - __builtin_clzll(n - 1)); }
+        reallocate(n);
+    }
+
+    void reallocate(std::size_t n) {
+        value_type *p = static_cast<value_type *>(memory::allocate(n * sizeof(value_type)));
+        std::copy_n(data(), count, p);
+        release();
+        heap = p;
+        cap = n;
+    }
+
+    void release() {
+        if (cap != N) { memory::deallocate(heap, cap * sizeof(value_type)); }
+        cap = N;
+    }
+
+    void steal(LimbVector &x) {
+        count = x.count;
+        cap = x.cap;
+        std::memcpy(local, x.local, sizeof(local));
+        x.count = 0;
+        x.cap = N;
+    }
+
+    static constexpr std::size_t MAX_POOLED_BYTES = std::size_t(1) << 20;
+};
+
+//limb storage with two limbs inline, enough for any 64 or 128 bit value.
+typedef LimbVector<2> Limbs;
+
+
+#endif //BIGINT_MEMORY_H
@@ -0,0 +1,287 @@
+//
+//@brief: Implementations of the modular reduction contexts of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Modular.h"
+#include "Divide.h"
+#include "Kernel.h"
+#include "Multiply.h"
+#include "Stats.h"
+#include <algorithm>
+#include <cstddef>
+
+typedef std::uint64_t limb;
+typedef Limbs Nat;
+
+const std::size_t REDC_THRESHOLD = 32;  // modulus limbs from which REDC is done by multiplications
+
+static void nat_trim(Nat &a) {
+    while (!a.empty() && a.back() == 0) { a.pop_back(); }
+}
+
+static int nat_cmp(const Nat &a, const Nat &b) {
+    if (a.size() != b.size()) { return a.size() < b.size() ? -1 : 1; }
+    return kernel::cmp_n(a.data(), b.data(), a.size());
+}
+
+//a -= b, requires a >= b.
+static void nat_sub(Nat &a, const Nat &b) {
+    kernel::sub(a.data(), a.data(), a.size(), b.data(), b.size());
+    nat_trim(a);
+}
+
+//a * b, the operands may carry leading zero limbs.
+static Nat nat_mul(const Nat &a, const Nat &b) {
+    Nat r;
+    if (a.empty() || b.empty()) { return r; }
+    r.resize(a.size() + b.size());
+    multiply_limbs(r.data(), a.data(), a.size(), b.data(), b.size());
+    nat_trim(r);
+    return r;
+}
+
+//a mod B^k as exactly k limbs.
+static Nat nat_low(const Nat &a, std::size_t k) {
+    Nat r(k, 0);
+    std::copy(a.begin(), a.begin() + std::min(k, a.size()), r.begin());
+    return r;
+}
+
+//a / B^k.
+static Nat nat_high(const Nat &a, std::size_t k) {
+    return k >= a.size() ? Nat() : Nat(a.begin() + k, a.end());
+}
+
+static Nat nat_mod(const Nat &a, const Nat &m) {
+    if (nat_cmp(a, m) < 0) { return a; }
+    Nat q, r;
+    divide_limbs(a, m, q, r);
+    return r;
+}
+
+//x^e in the domain of a context, mul being its product, by left-to-right sliding windows.
+template<class Mul>
+static Nat window_pow(const Nat &x, const Nat &e, const Nat &one, const Mul &mul) {
+    const std::ptrdiff_t bits = e.empty() ? 0 : 64 * e.size() - __builtin_clzll(e.back());
+    if (bits == 0) { return one; }
+    const int k = bits <= 8 ? 1 : bits <= 24 ? 2 : bits <= 80 ? 3 : bits <= 240 ? 4 : bits <= 672 ? 5 : 6;
+    auto bit = [&e](std::ptrdiff_t i) { return (e[i / 64] >> (i % 64)) & 1; };
+
+//    Odd powers x, x^3, ..., x^(2^k - 1).
+    std::vector<Nat> table(std::size_t(1) << (k - 1));
+    table[0] = x;
+    if (k > 1) {
+        Nat x2 = mul(x, x);
+        for (std::size_t i = 1; i < table.size(); i++) { table[i] = mul(table[i - 1], x2); }
+    }
+
+    Nat r;
+    bool started = false;
+    for (std::ptrdiff_t i = bits - 1; i >= 0;) {
+        if (bit(i) == 0) {
+            r = mul(r, r);
+            i--;
+            continue;
+        }
+        std::ptrdiff_t j = std::max<std::ptrdiff_t>(i - k + 1, 0);
+        while (bit(j) == 0) { j++; }
+        std::size_t w = 0;
+        for (std::ptrdiff_t l = i; l >= j; l--) { w = w * 2 + bit(l); }
+        if (started) {
+            for (std::ptrdiff_t l = j; l <= i; l++) { r = mul(r, r); }
+            r = mul(r, table[w >> 1]);
+        } else {
+            r = table[w >> 1];
+            started = true;
+        }
+        i = j - 1;
+    }
+    return r;
+}
+
+ModularContext::ModularContext(const BigInt &x) : mod(x), m(x.limbs) {
+    if (m.empty()) { throw "Can't divide by zero."; }
+    mod.negative = false;
+}
+
+const BigInt &ModularContext::modulus() const {
+    return mod;
+}
+
+BigInt ModularContext::residue(const BigInt &x) const {
+    return make(residue_of(x));
+}
+
+//x mod m in [0, m).
+Nat ModularContext::residue_of(const BigInt &x) const {
+    Nat r = nat_mod(x.limbs, m);
+    if (x.negative && !r.empty()) {
+        Nat t = m;
+        nat_sub(t, r);
+        r.swap(t);
+    }
+    return r;
+}
+
+const Nat &ModularContext::exponent_of(const BigInt &e) {
+    if (e.negative) { throw "Invalid exponent."; }
+    return e.limbs;
+}
+
+const Nat &ModularContext::limbs_of(const BigInt &x) {
+    return x.limbs;
+}
+
+bool ModularContext::negative_of(const BigInt &x) {
+    return x.negative;
+}
+
+BigInt ModularContext::make(Nat r) {
+    BigInt result;
+    nat_trim(r);
+    result.limbs.swap(r);
+    return result;
+}
+
+Montgomery::Montgomery(const BigInt &x) : ModularContext(x) {
+    if ((m[0] & 1) == 0) { throw "Montgomery modulus must be odd."; }
+    const std::size_t k = m.size();
+
+//    m^-1 mod 2^64 by Newton's iteration, each step doubling the correct low bits.
+    limb inv = m[0];
+    for (int i = 0; i < 5; i++) { inv *= 2 - m[0] * inv; }
+    n0 = -inv;
+
+    if (k >= REDC_THRESHOLD) {
+//        Lift the inverse to m^-1 mod B^k the same way: x = x * (2 - m * x) mod B^j, j doubling.
+        Nat y(1, inv);
+        for (std::size_t j = 1; j < k;) {
+            j = std::min(2 * j, k);
+            Nat e = nat_low(nat_mul(nat_low(m, j), y), j);
+            for (limb &v : e) { v = ~v; }
+            limb three = 3;
+            kernel::add(e.data(), e.data(), j, &three, 1);
+            y = nat_low(nat_mul(y, e), j);
+        }
+        for (limb &v : y) { v = ~v; }
+        limb one = 1;
+        kernel::add(y.data(), y.data(), k, &one, 1);
+        minv.swap(y);
+    }
+
+    Nat p(2 * k + 1, 0);
+    p[2 * k] = 1;
+    r2 = nat_mod(p, m);
+}
+
+//t * R^-1 mod m for t < m * R.
+Nat Montgomery::redc(Nat t) const {
+    const std::size_t k = m.size();
+    t.resize(2 * k + 1, 0);
+    if (k < REDC_THRESHOLD) {
+        for (std::size_t i = 0; i < k; i++) {
+            limb c = kernel::addmul_1(t.data() + i, m.data(), k, t[i] * n0);
+            kernel::add(t.data() + i + k, t.data() + i + k, k + 1 - i, &c, 1);
+        }
+    } else {
+//        q = (t mod R) * (-m^-1) mod R makes t + q * m a multiple of R.
+        Nat q = nat_low(nat_mul(nat_low(t, k), minv), k);
+        Nat qm = nat_mul(q, m);
+        kernel::add(t.data(), t.data(), t.size(), qm.data(), qm.size());
+    }
+    Nat r(t.begin() + k, t.end());
+    nat_trim(r);
+    if (nat_cmp(r, m) >= 0) { nat_sub(r, m); }
+    return r;
+}
+
+BigInt Montgomery::to_montgomery(const BigInt &x) const {
+    return make(redc(nat_mul(residue_of(x), r2)));
+}
+
+BigInt Montgomery::from_montgomery(const BigInt &x) const {
+    return make(redc(residue_of(x)));
+}
+
+BigInt Montgomery::multiply(const BigInt &a, const BigInt &b) const {
+    BIGINT_STAT_OP(MulMod, m.size());
+    return make(redc(nat_mul(residue_of(a), residue_of(b))));
+}
+
+BigInt Montgomery::mulmod(const BigInt &a, const BigInt &b) const {
+    BIGINT_STAT_OP(MulMod, m.size());
+//    a b R^-1, then multiplied by R^2 and reduced once more to cancel the R^-1.
+    return make(redc(nat_mul(redc(nat_mul(residue_of(a), residue_of(b))), r2)));
+}
+
+BigInt Montgomery::powmod(const BigInt &base, const BigInt &e) const {
+    BIGINT_STAT_OP(PowMod, m.size());
+    Nat x = redc(nat_mul(residue_of(base), r2));
+    Nat one = redc(r2);
+    Nat r = window_pow(x, exponent_of(e), one, [this](const Nat &a, const Nat &b) { return redc(nat_mul(a, b)); });
+    return make(redc(r));
+}
+
+Barrett::Barrett(const BigInt &x) : ModularContext(x) {
+    const std::size_t k = m.size();
+    Nat p(2 * k + 1, 0), r;
+    p[2 * k] = 1;
+    divide_limbs(p, m, mu, r);
+}
+
+//x mod m, by Barrett's method (HAC 14.42) when x < B^2k.
+Nat Barrett::reduce_nat(const Nat &x) const {
+    const std::size_t k = m.size();
+    if (x.size() > 2 * k) { return nat_mod(x, m); }
+    if (nat_cmp(x, m) < 0) { return x; }
+    Nat q = nat_high(nat_mul(nat_high(x, k - 1), mu), k + 1);
+    Nat r = nat_low(x, k + 1), qm = nat_low(nat_mul(q, m), k + 1);
+//    x - q m is below 3m and so fits in k + 1 limbs: the borrow out of them can be dropped.
+    kernel::sub_n(r.data(), r.data(), qm.data(), k + 1);
+    nat_trim(r);
+    while (nat_cmp(r, m) >= 0) { nat_sub(r, m); }
+    return r;
+}
+
+BigInt Barrett::reduce(const BigInt &x) const {
+    if (negative_of(x)) { return residue(x); }
+    return make(reduce_nat(limbs_of(x)));
+}
+
+BigInt Barrett::mulmod(const BigInt &a, const BigInt &b) const {
+    BIGINT_STAT_OP(MulMod, m.size());
+    return make(reduce_nat(nat_mul(residue_of(a), residue_of(b))));
+}
+
+BigInt Barrett::powmod(const BigInt &base, const BigInt &e) const {
+    BIGINT_STAT_OP(PowMod, m.size());
+    Nat x = residue_of(base);
+    Nat one = nat_mod(Nat(1, 1), m);
+    return make(window_pow(x, exponent_of(e), one, [this](const Nat &a, const Nat &b) { return reduce_nat(nat_mul(a, b)); }));
+}
+
+BigInt powmod(const BigInt &base, const BigInt &e, const BigInt &mod) {
+//    Odd moduli go through Montgomery form, the others through Barrett reduction.
+    BIGINT_STAT_OP(PowMod, mod.limbs.size());
+    if (!mod.limbs.empty() && (mod.limbs[0] & 1) != 0) { return Montgomery(mod).powmod(base, e); }
+    return Barrett(mod).powmod(base, e);
+}
+
+BigInt mulmod(const BigInt &a, const BigInt &b, const BigInt &mod) {
+//    A single product needs a single division, the contexts pay off for repeated ones.
+    BIGINT_STAT_OP(MulMod, mod.limbs.size());
+    BigInt q, r;
+    (a * b).divmod(mod, q, r);
+    if (r.negative) {
+        r.negative = false;
+        BigInt t(mod);
+        t.negative = false;
+        r = t.minus(r);
+    }
+    return r;
+}
@@ -0,0 +1,103 @@
+//
+//@brief: Definitions for the modular reduction contexts of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_MODULAR_H
+#define BIGINT_MODULAR_H
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "BigInt.h"
+
+/**
+ *  What the reduction contexts share: the modulus |m| (a negative modulus is taken by its magnitude,
+ * zero throws), and residues, which are always in [0, |m|) whatever the sign of the input.
+ */
+class ModularContext {
+public:
+    const BigInt &modulus() const;
+
+    BigInt residue(const BigInt &) const;
+
+protected:
+    typedef Limbs Nat;
+
+    BigInt mod;
+    Nat m;          // limbs of the modulus
+
+    explicit ModularContext(const BigInt &);
+
+    Nat residue_of(const BigInt &) const;
+
+    static const Nat &exponent_of(const BigInt &);
+
+    static const Nat &limbs_of(const BigInt &);
+
+    static bool negative_of(const BigInt &);
+
+    static BigInt make(Nat);
+};
+
+/**
+ *  Montgomery arithmetic modulo an odd m of k limbs, with R = 2^(64k). R^2 mod m and the REDC
+ * constants are computed once, then every product is reduced without any division: word by word
+ * for short moduli, by two multiplications through the fast tiers for long ones.
+ *  multiply() works on values already in Montgomery form (see to_montgomery()), which is the cheap
+ * way to chain many products, mulmod() takes and returns plain residues.
+ */
+class Montgomery : public ModularContext {
+public:
+    explicit Montgomery(const BigInt &);
+
+    BigInt to_montgomery(const BigInt &) const;
+
+    BigInt from_montgomery(const BigInt &) const;
+
+    BigInt multiply(const BigInt &, const BigInt &) const;
+
+    BigInt mulmod(const BigInt &, const BigInt &) const;
+
+    BigInt powmod(const BigInt &, const BigInt &) const;
+
+private:
+    std::uint64_t n0;   // -m^-1 mod 2^64
+    Nat minv;           // -m^-1 mod R, for the multiplication based REDC
+    Nat r2;             // R^2 mod m
+
+    Nat redc(Nat) const;
+};
+
+/**
+ *  Barrett reduction modulo any m of k limbs: mu = floor(2^(128k) / m) is computed once, then a
+ * value below m^2 is reduced with two multiplications and at most two subtractions.
+ */
+class Barrett : public ModularContext {
+public:
+    explicit Barrett(const BigInt &);
+
+    BigInt reduce(const BigInt &) const;
+
+    BigInt mulmod(const BigInt &, const BigInt &) const;
+
+    BigInt powmod(const BigInt &, const BigInt &) const;
+
+private:
+    Nat mu;
+
+    Nat reduce_nat(const Nat &) const;
+};
+
+//base^e mod |m| in [0, |m|), through Montgomery form for odd moduli and Barrett reduction otherwise.
+BigInt powmod(const BigInt &, const BigInt &, const BigInt &);
+
+//a * b mod |m| in [0, |m|).
+BigInt mulmod(const BigInt &, const BigInt &, const BigInt &);
+
+
+#endif //BIGINT_MODULAR_H
@@ -0,0 +1,383 @@
+//
+//@brief: Implementations of the size-tiered multiplication dispatcher used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Multiply.h"
+#include "BigInt.h"
+#include "Kernel.h"
+#include "Memory.h"
+#include "Transform.h"
+#include "ThreadPool.h"
+#include "Stats.h"
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <bit>
+
+typedef std::uint64_t limb;
+typedef unsigned __int128 dlimb;
+
+static std::atomic<BigInt::MultiplyEngine> engine(BigInt::MultiplyEngine::NTT);
+static std::atomic<std::size_t> karatsuba_threshold(BigInt::MultiplyThresholds().karatsuba);
+static std::atomic<std::size_t> toom3_threshold(BigInt::MultiplyThresholds().toom3);
+static std::atomic<std::size_t> transform_threshold(BigInt::MultiplyThresholds().transform);
+static std::atomic<std::size_t> parallel_threshold(BigInt::MultiplyThresholds().parallel);
+
+//a signed intermediate value of Toom-Cook interpolation.
+struct Term {
+    Limbs d;                // magnitude, no leading zero limbs
+    bool neg = false;
+};
+
+static void trim_term(Term &t) {
+    while (!t.d.empty() && t.d.back() == 0) { t.d.pop_back(); }
+    if (t.d.empty()) { t.neg = false; }
+}
+
+static Term make_term(const limb *a, std::size_t n) {
+    BIGINT_STAT_ALLOC(n * sizeof(limb));
+    Term t;
+    t.d.assign(a, a + n);
+    trim_term(t);
+    return t;
+}
+
+//x + y, or x - y when sub is set.
+static Term add_term(const Term &x, const Term &y, bool sub) {
+    Term r;
+    bool yneg = y.neg != sub;
+    if (x.neg == yneg) {
+        const Term &big = x.d.size() >= y.d.size() ? x : y;
+        const Term &small = x.d.size() >= y.d.size() ? y : x;
+        r.d.resize(big.d.size() + 1);
+        BIGINT_STAT_ALLOC(r.d.size() * sizeof(limb));
+        r.d[big.d.size()] = kernel::add(r.d.data(), big.d.data(), big.d.size(), small.d.data(), small.d.size());
+        r.neg = x.neg;
+    } else {
+        int c = x.d.size() != y.d.size() ? (x.d.size() < y.d.size() ? -1 : 1)
+                                          : kernel::cmp_n(x.d.data(), y.d.data(), x.d.size());
+        const Term &big = c >= 0 ? x : y;
+        const Term &small = c >= 0 ? y : x;
+        r.d.resize(big.d.size());
+        BIGINT_STAT_ALLOC(r.d.size() * sizeof(limb));
+        kernel::sub(r.d.data(), big.d.data(), big.d.size(), small.d.data(), small.d.size());
+        r.neg = c >= 0 ? x.neg : yneg;
+    }
+    trim_term(r);
+    return r;
+}
+
+static Term mul_term(const Term &x, const Term &y) {
+    Term r;
+    if (x.d.empty() || y.d.empty()) { return r; }
+    r.d.resize(x.d.size() + y.d.size());
+    BIGINT_STAT_ALLOC(r.d.size() * sizeof(limb));
+    multiply_limbs(r.d.data(), x.d.data(), x.d.size(), y.d.data(), y.d.size());
+    r.neg = x.neg != y.neg;
+    trim_term(r);
+    return r;
+}
+
+//t <<= 1.
+static void shl1_term(Term &t) {
+    limb carry = 0;
+    for (limb &x : t.d) {
+        limb next = x >> 63;
+        x = (x << 1) | carry;
+        carry = next;
+    }
+    if (carry != 0) { t.d.push_back(carry); }
+}
+
+//t >>= 1, the value must be even.
+static void shr1_term(Term &t) {
+    for (std::size_t i = 0; i < t.d.size(); i++) {
+        t.d[i] = (t.d[i] >> 1) | (i + 1 < t.d.size() ? t.d[i + 1] << 63 : 0);
+    }
+    trim_term(t);
+}
+
+//t /= 3, the value must be a multiple of 3 (exact division by the inverse of 3 modulo 2^64).
+static void div3_term(Term &t) {
+    const limb inv3 = 0xAAAAAAAAAAAAAAABULL;
+    limb carry = 0;
+    for (limb &x : t.d) {
+        limb borrow = x < carry ? 1 : 0;
+        limb q = (x - carry) * inv3;
+        x = q;
+        carry = borrow + static_cast<limb>((static_cast<dlimb>(q) * 3) >> 64);
+    }
+    trim_term(t);
+}
+
+//out += t * B^offset, where t is a non-negative coefficient of the product.
+static void add_term_at(limb *out, std::size_t len, const Term &t, std::size_t offset) {
+    if (t.d.empty() || offset >= len) { return; }
+    kernel::add(out + offset, out + offset, len - offset, t.d.data(), std::min(t.d.size(), len - offset));
+}
+
+//Karatsuba's method, requires n >= m > ceil(n / 2).
+static void mul_karatsuba(limb *out, const limb *a, std::size_t n, const limb *b, std::size_t m) {
+    BIGINT_STAT_TIER(Karatsuba);
+    const bool square = a == b && n == m;
+    std::size_t h = (n + 1) / 2;
+    memory::Scratch scratch;
+    limb *sa = scratch.take<limb>(h + 1), *sb = square ? sa : scratch.take<limb>(h + 1);
+    limb *z1 = scratch.take<limb>(2 * h + 2);
+    BIGINT_STAT_ALLOC((4 * h + 4) * sizeof(limb));
+    sa[h] = kernel::add(sa, a, h, a + h, n - h);
+    if (!square) { sb[h] = kernel::add(sb, b, h, b + h, m - h); }
+
+//    z1 = (a0 + a1)(b0 + b1) - a0 b0 - a1 b1, the three products are independent.
+    std::shared_ptr<ThreadPool> pool = task_pool(h);
+    TaskGroup tasks(pool.get());
+    tasks.run([&] { multiply_limbs(z1, sa, h + 1, sb, h + 1); });
+    tasks.run([&] { multiply_limbs(out, a, h, b, h); });
+    multiply_limbs(out + 2 * h, a + h, n - h, b + h, m - h);
+    tasks.wait();
+    kernel::sub(z1, z1, 2 * h + 2, out, 2 * h);
+    kernel::sub(z1, z1, 2 * h + 2, out + 2 * h, n + m - 2 * h);
+    kernel::add(out + h, out + h, n + m - h, z1, std::min(2 * h + 2, n + m - h));
+}
+
+//Toom-Cook 3-way with the evaluation points 0, 1, -1, -2 and infinity, requires n >= m > ceil(n / 2).
+static void mul_toom3(limb *out, const limb *a, std::size_t n, const limb *b, std::size_t m) {
+    BIGINT_STAT_TIER(Toom3);
+    const bool square = a == b && n == m;
+    std::size_t k = (n + 2) / 3;
+    Term a0 = make_term(a, k), a1 = make_term(a + k, k), a2 = make_term(a + 2 * k, n - 2 * k);
+    Term b0 = make_term(b, k), b1 = make_term(b + k, std::min(k, m - k));
+    Term b2 = m > 2 * k ? make_term(b + 2 * k, m - 2 * k) : Term();
+
+//    Evaluation.
+    Term t = add_term(a0, a2, false);
+    Term p1 = add_term(t, a1, false), pm1 = add_term(t, a1, true);
+    Term pm2 = add_term(pm1, a2, false);
+    shl1_term(pm2);
+    pm2 = add_term(pm2, a0, true);
+    Term q1 = p1, qm1 = pm1, qm2 = pm2;
+    if (!square) {
+        t = add_term(b0, b2, false);
+        q1 = add_term(t, b1, false);
+        qm1 = add_term(t, b1, true);
+        qm2 = add_term(qm1, b2, false);
+        shl1_term(qm2);
+        qm2 = add_term(qm2, b0, true);
+    }
+
+//    Pointwise products.
+//    When squaring both factors are the same Term, so every product takes the squaring path again.
+    Term r0, r1, rm1, rm2, rinf;
+    std::shared_ptr<ThreadPool> pool = task_pool(k);
+    TaskGroup tasks(pool.get());
+    tasks.run([&] { r0 = mul_term(a0, square ? a0 : b0); });
+    tasks.run([&] { r1 = mul_term(p1, square ? p1 : q1); });
+    tasks.run([&] { rm1 = mul_term(pm1, square ? pm1 : qm1); });
+    tasks.run([&] { rm2 = mul_term(pm2, square ? pm2 : qm2); });
+    rinf = mul_term(a2, square ? a2 : b2);
+    tasks.wait();
+
+//    Interpolation, following Bodrato's sequence.
+    Term c3 = add_term(rm2, r1, true);
+    div3_term(c3);
+    Term c1 = add_term(r1, rm1, true);
+    shr1_term(c1);
+    Term c2 = add_term(rm1, r0, true);
+    c3 = add_term(c2, c3, true);
+    shr1_term(c3);
+    Term twice_inf = rinf;
+    shl1_term(twice_inf);
+    c3 = add_term(c3, twice_inf, false);
+    c2 = add_term(add_term(c2, c1, false), rinf, true);
+    c1 = add_term(c1, c3, true);
+
+    for (std::size_t i = 0; i < n + m; i++) { out[i] = 0; }
+    add_term_at(out, n + m, r0, 0);
+    add_term_at(out, n + m, c1, k);
+    add_term_at(out, n + m, c2, 2 * k);
+    add_term_at(out, n + m, c3, 3 * k);
+    add_term_at(out, n + m, rinf, 4 * k);
+}
+
+//mul_unbalanced on a pool: slice i covers out[i * m, (i + 2) * m), so the even slices are written
+//side by side first, then the odd slices are added side by side and their carries are passed on.
+static void mul_unbalanced_parallel(limb *out, const limb *a, std::size_t n, const limb *b, std::size_t m,
+                                    ThreadPool &pool) {
+    const std::size_t slices = (n + m - 1) / m;
+    std::vector<limb> carries(slices, 0);
+    for (std::size_t i = 0; i < n + m; i++) { out[i] = 0; }
+    pool.parallel_for((slices + 1) / 2, [&](std::size_t j) {
+        std::size_t off = 2 * j * m;
+        multiply_limbs(out + off, a + off, std::min(m, n - off), b, m);
+    });
+    pool.parallel_for(slices / 2, [&](std::size_t j) {
+        std::size_t off = (2 * j + 1) * m, len = std::min(m, n - off);
+        memory::Scratch scratch;
+        limb *tmp = scratch.take<limb>(len + m);
+        BIGINT_STAT_ALLOC((len + m) * sizeof(limb));
+        multiply_limbs(tmp, a + off, len, b, m);
+        carries[2 * j + 1] = kernel::add(out + off, out + off, len + m, tmp, len + m);
+    });
+    for (std::size_t i = 1; i < slices; i += 2) {
+        std::size_t end = (i + 2) * m;
+        if (carries[i] != 0 && end < n + m) { kernel::add(out + end, out + end, n + m - end, &carries[i], 1); }
+    }
+}
+
+//cut a into slices of m limbs and accumulate every slice times b, requires n >= m.
+static void mul_unbalanced(limb *out, const limb *a, std::size_t n, const limb *b, std::size_t m) {
+    BIGINT_STAT_TIER(Unbalanced);
+    if (std::shared_ptr<ThreadPool> pool = task_pool(m)) {
+        mul_unbalanced_parallel(out, a, n, b, m, *pool);
+        return;
+    }
+    memory::Scratch scratch;
+    limb *tmp = scratch.take<limb>(2 * m);
+    BIGINT_STAT_ALLOC(2 * m * sizeof(limb));
+    for (std::size_t i = 0; i < n + m; i++) { out[i] = 0; }
+    for (std::size_t off = 0; off < n; off += m) {
+        std::size_t len = std::min(m, n - off);
+        multiply_limbs(tmp, a + off, len, b, m);
+        kernel::add(out + off, tmp, len + m, out + off, m);
+    }
+}
+
+void multiply_limbs(limb *out, const limb *a, std::size_t n, const limb *b, std::size_t m) {
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    if (m == 0) {
+        for (std::size_t i = 0; i < n; i++) { out[i] = 0; }
+        return;
+    }
+    if (m < karatsuba_threshold.load(std::memory_order_relaxed)) {
+        BIGINT_STAT_TIER(Basecase);
+        if (a == b && n == m) { kernel::sqr_basecase(out, a, n); }
+        else { kernel::mul_basecase(out, a, n, b, m); }
+    } else if (m >= transform_threshold.load(std::memory_order_relaxed)) {
+        std::shared_ptr<ThreadPool> pool;
+        if (m >= parallel_threshold.load(std::memory_order_relaxed)) { pool = parallel_pool(); }
+        if (engine.load(std::memory_order_relaxed) == BigInt::MultiplyEngine::FFT) {
+            fft_multiply(a, n, b, m, out, pool.get());
+        } else { ntt_multiply(a, n, b, m, out, pool.get()); }
+    } else if (m <= (n + 1) / 2) {
+        mul_unbalanced(out, a, n, b, m);
+    } else if (m < toom3_threshold.load(std::memory_order_relaxed)) {
+        mul_karatsuba(out, a, n, b, m);
+    } else {
+        mul_toom3(out, a, n, b, m);
+    }
+}
+
+void square_limbs(limb *out, const limb *a, std::size_t n) {
+    multiply_limbs(out, a, n, a, n);
+}
+
+std::size_t prepared_length(std::size_t n, std::size_t m) {
+    if (std::min(n, m) == 0 || std::min(n, m) < transform_threshold.load(std::memory_order_relaxed)) { return 0; }
+    return std::bit_ceil(n + m - 1);
+}
+
+PreparedTransform prepare_limbs(const limb *b, std::size_t m, std::size_t len) {
+    std::shared_ptr<ThreadPool> pool;
+    if (m >= parallel_threshold.load(std::memory_order_relaxed)) { pool = parallel_pool(); }
+    PreparedTransform t;
+    t.len = len;
+    t.residues.resize(3 * len);
+    BIGINT_STAT_ALLOC(t.residues.size() * sizeof(limb));
+    ntt_prepare(b, m, len, t.residues.data(), pool.get());
+    return t;
+}
+
+void multiply_prepared(limb *out, const limb *a, std::size_t n, std::size_t m, const PreparedTransform &t) {
+    std::shared_ptr<ThreadPool> pool;
+    if (std::min(n, m) >= parallel_threshold.load(std::memory_order_relaxed)) { pool = parallel_pool(); }
+    ntt_multiply_prepared(a, n, t.residues.data(), m, t.len, out, pool.get());
+}
+
+void BigInt::set_multiply_engine(MultiplyEngine e) {
+//    Select the transform used by operator*, so both engines can be benchmarked.
+    engine.store(e, std::memory_order_relaxed);
+}
+
+BigInt::MultiplyEngine BigInt::multiply_engine() {
+    return engine.load(std::memory_order_relaxed);
+}
+
+void BigInt::set_multiply_thresholds(const MultiplyThresholds &t) {
+    karatsuba_threshold.store(std::max<std::size_t>(t.karatsuba, 2), std::memory_order_relaxed);
+    toom3_threshold.store(std::max<std::size_t>(t.toom3, 3), std::memory_order_relaxed);
+    transform_threshold.store(std::max<std::size_t>(t.transform, 1), std::memory_order_relaxed);
+    parallel_threshold.store(std::max<std::size_t>(t.parallel, 1), std::memory_order_relaxed);
+}
+
+BigInt::MultiplyThresholds BigInt::multiply_thresholds() {
+    MultiplyThresholds t;
+    t.karatsuba = karatsuba_threshold.load(std::memory_order_relaxed);
+    t.toom3 = toom3_threshold.load(std::memory_order_relaxed);
+    t.transform = transform_threshold.load(std::memory_order_relaxed);
+    t.parallel = parallel_threshold.load(std::memory_order_relaxed);
+    return t;
+}
+
+//best of three timings of an n x n product under the given thresholds, in nanoseconds.
+static double time_multiply(std::size_t n, const BigInt::MultiplyThresholds &t) {
+    std::mt19937_64 gen(n);
+    std::vector<limb> a(n), b(n), out(2 * n);
+    for (std::size_t i = 0; i < n; i++) {
+        a[i] = gen();
+        b[i] = gen();
+    }
+    BigInt::set_multiply_thresholds(t);
+    double best = 1e300;
+    for (int round = 0; round < 3; round++) {
+        int reps = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed;
+        do {
+            multiply_limbs(out.data(), a.data(), n, b.data(), n);
+            reps++;
+            elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < 2e6);
+        best = std::min(best, elapsed / reps);
+    }
+    return best;
+}
+
+//smallest size of the sweep from which the next tier (threshold set to the size) beats the current one.
+static std::size_t tune_tier(std::size_t BigInt::MultiplyThresholds::*tier, BigInt::MultiplyThresholds t,
+                             std::size_t from, std::size_t to) {
+    for (std::size_t n = from; n < to; n += std::max<std::size_t>(n / 4, 1)) {
+        BigInt::MultiplyThresholds next = t, current = t;
+        next.*tier = n;
+        current.*tier = n + 1;
+        if (time_multiply(n, next) < time_multiply(n, current)) { return n; }
+    }
+    return to;
+}
+
+BigInt::MultiplyThresholds BigInt::tune_multiply() {
+//    Measure every crossover on this host, one tier at a time, then install the result.
+//    Call it once at start up: the thresholds are switched globally while it runs.
+//    The tiers are timed on one thread, the parallel threshold is kept as it was.
+    const std::size_t never = static_cast<std::size_t>(-1);
+    const std::size_t parallel = parallel_threshold.load(std::memory_order_relaxed);
+    MultiplyThresholds t;
+    t.toom3 = never;
+    t.transform = never;
+    t.parallel = never;
+    t.karatsuba = tune_tier(&MultiplyThresholds::karatsuba, t, 4, 256);
+    t.toom3 = tune_tier(&MultiplyThresholds::toom3, t, std::max<std::size_t>(t.karatsuba * 2, 8), 4096);
+    t.transform = tune_tier(&MultiplyThresholds::transform, t, std::max<std::size_t>(t.toom3, 16), 65536);
+    t.parallel = parallel;
+    set_multiply_thresholds(t);
+    return t;
+}
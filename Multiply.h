@@ -0,0 +1,52 @@
+//
+//@brief: Definitions for the size-tiered multiplication dispatcher used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_MULTIPLY_H
+#define BIGINT_MULTIPLY_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ *  Multiply a[0..n) by b[0..m) into out[0..n+m), out must not alias a or b. The algorithm is picked
+ * from the length of the smaller operand: schoolbook, Karatsuba, Toom-Cook 3-way, then the selected
+ * transform engine, as configured by BigInt::set_multiply_thresholds(). Very unbalanced operands are
+ * cut into slices of the smaller length first.
+ *  Passing the same pointer and length for both operands is recognized as a square at every tier:
+ * the schoolbook method computes each cross product once, Karatsuba and Toom-Cook evaluate one
+ * operand, and the transforms run a single forward transform.
+ */
+void multiply_limbs(std::uint64_t *out, const std::uint64_t *a, std::size_t n,
+                    const std::uint64_t *b, std::size_t m);
+
+//out[0..2n) = a[0..n)^2, out must not alias a.
+void square_limbs(std::uint64_t *out, const std::uint64_t *a, std::size_t n);
+
+//the forward transform of a factor, kept to multiply by it again without transforming it.
+struct PreparedTransform {
+    std::size_t len = 0;                    // points, serves products of up to len + 1 limbs
+    std::vector<std::uint64_t> residues;    // the number theoretic transforms, len per prime
+};
+
+//the transform length of a product of n by m limbs when multiply_limbs() runs it in the transform
+//tier, 0 when it takes a tier below.
+std::size_t prepared_length(std::size_t n, std::size_t m);
+
+//the transform of b[0..m) at len points.
+PreparedTransform prepare_limbs(const std::uint64_t *b, std::size_t m, std::size_t len);
+
+//out[0..n+m) = a[0..n) * b[0..m) where t is the transform of b, at prepared_length(n, m) points or
+//more. Transforms are number theoretic whichever engine is selected, so the product is exact.
+void multiply_prepared(std::uint64_t *out, const std::uint64_t *a, std::size_t n, std::size_t m,
+                       const PreparedTransform &t);
+
+
+#endif //BIGINT_MULTIPLY_H
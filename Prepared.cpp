@@ -0,0 +1,180 @@
+//
+//@brief: Implementations of PreparedInt and TransformCache, factors kept with their transforms.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Prepared.h"
+#include <algorithm>
+#include "Multiply.h"
+#include "Stats.h"
+
+typedef BigInt::limb limb;
+
+//a hash of a magnitude and a transform length.
+static std::size_t key_of(const Limbs &d, std::size_t len) {
+    std::uint64_t h = static_cast<std::uint64_t>(len) * 0x9e3779b97f4a7c15;
+    for (std::size_t i = 0; i < d.size(); i++) {
+        h = (h ^ d[i]) * 0xff51afd7ed558ccd;
+        h ^= h >> 32;
+    }
+    return static_cast<std::size_t>(h);
+}
+
+static bool same_limbs(const Limbs &a, const Limbs &b) {
+    return a.size() == b.size() && std::equal(a.data(), a.data() + a.size(), b.data());
+}
+
+PreparedInt::PreparedInt(const BigInt &v) : x(v) {}
+
+PreparedInt::PreparedInt(BigInt &&v) : x(std::move(v)) {}
+
+const BigInt &PreparedInt::value() const {
+    return this->x;
+}
+
+BigInt PreparedInt::multiply(const BigInt &a) const {
+//    a * value(), the same as a * value() without the prepared transforms.
+    return product(a, this->x, [this](std::size_t len) { return this->transform(len); });
+}
+
+void PreparedInt::prepare(std::size_t limbs) const {
+//    Make the transform for products with factors of the given length now, e.g. before the threads
+//    sharing this start, so that none of them waits for it.
+    if (const std::size_t len = prepared_length(limbs, this->x.limbs.size())) { this->transform(len); }
+}
+
+std::size_t PreparedInt::transform_bytes() const {
+//    Memory held by the transforms made so far.
+    std::lock_guard<std::mutex> lock(this->mu);
+    std::size_t total = 0;
+    for (const Transform &t : this->transforms) { total += t->residues.size() * sizeof(limb); }
+    return total;
+}
+
+//the transform at len points, made the first time it is asked for.
+PreparedInt::Transform PreparedInt::transform(std::size_t len) const {
+    {
+        std::lock_guard<std::mutex> lock(this->mu);
+        for (const Transform &t : this->transforms) {
+            if (t->len == len) { return t; }
+        }
+    }
+//    Made outside the lock, as in TransformCache::find: a long build forks onto the pool, whose wait()
+//    may run a product by this value on the same thread, and products at other lengths go on meanwhile.
+    Transform made = std::make_shared<const PreparedTransform>(prepare_limbs(this->x.limbs.data(), this->x.limbs.size(), len));
+    std::lock_guard<std::mutex> lock(this->mu);
+    for (const Transform &t : this->transforms) {
+        if (t->len == len) { return t; }
+    }
+    this->transforms.push_back(made);
+    return made;
+}
+
+//a * b, through the transform of b that transform(len) supplies when the product reaches the transform tier.
+BigInt PreparedInt::product(const BigInt &a, const BigInt &b, const std::function<Transform(std::size_t)> &transform) {
+    BIGINT_STAT_OP(Mul, std::max(a.limbs.size(), b.limbs.size()));
+    BigInt result;
+    const std::size_t n = a.limbs.size(), m = b.limbs.size();
+    if (n == 0 || m == 0) { return result; }
+    result.limbs.resize_for_overwrite(n + m);
+    BIGINT_STAT_ALLOC((n + m) * sizeof(limb));
+    if (const std::size_t len = prepared_length(n, m)) {
+        multiply_prepared(result.limbs.data(), a.limbs.data(), n, m, *transform(len));
+    } else { multiply_limbs(result.limbs.data(), a.limbs.data(), n, b.limbs.data(), m); }
+    result.negative = a.negative != b.negative;
+    result.normalize();
+    return result;
+}
+
+BigInt operator*(const BigInt &a, const PreparedInt &b) {
+    return b.multiply(a);
+}
+
+BigInt operator*(const PreparedInt &a, const BigInt &b) {
+    return a.multiply(b);
+}
+
+TransformCache::TransformCache(std::size_t bytes) : limit(bytes) {}
+
+BigInt TransformCache::multiply(const BigInt &a, const BigInt &b) {
+//    a * b with b as the factor that recurs.
+    return PreparedInt::product(a, b, [&](std::size_t len) { return this->find(b, len); });
+}
+
+std::size_t TransformCache::size() const {
+//    Bytes held by the cached values and their transforms.
+    std::lock_guard<std::mutex> lock(this->mu);
+    return this->bytes;
+}
+
+std::size_t TransformCache::capacity() const {
+    std::lock_guard<std::mutex> lock(this->mu);
+    return this->limit;
+}
+
+void TransformCache::set_capacity(std::size_t bytes) {
+//    Entries past the new capacity go at once, the least recently used first.
+    std::lock_guard<std::mutex> lock(this->mu);
+    this->limit = bytes;
+    this->trim();
+}
+
+void TransformCache::clear() {
+    std::lock_guard<std::mutex> lock(this->mu);
+    this->index.clear();
+    this->entries.clear();
+    this->bytes = 0;
+}
+
+//the transform of |b| at len points, from the cache or made and cached.
+std::shared_ptr<const PreparedTransform> TransformCache::find(const BigInt &b, std::size_t len) {
+    const std::size_t key = key_of(b.limbs, len);
+    {
+        std::lock_guard<std::mutex> lock(this->mu);
+        if (auto t = this->lookup(b.limbs, len, key)) { return t; }
+    }
+//    Made outside the lock so other products go on meanwhile. Two threads missing on the same
+//    value both make it, and the second one keeps the first one's.
+    auto made = std::make_shared<const PreparedTransform>(prepare_limbs(b.limbs.data(), b.limbs.size(), len));
+    const std::size_t cost = (made->residues.size() + b.limbs.size()) * sizeof(limb);
+    std::lock_guard<std::mutex> lock(this->mu);
+    if (auto t = this->lookup(b.limbs, len, key)) { return t; }
+    if (cost <= this->limit) {
+        this->entries.push_front(Entry{b.limbs, key, made, cost});
+        this->index.emplace(key, this->entries.begin());
+        this->bytes += cost;
+        this->trim();
+    }
+    return made;
+}
+
+//the cached transform of the magnitude d at len points, moved to the front, or null.
+std::shared_ptr<const PreparedTransform> TransformCache::lookup(const Limbs &d, std::size_t len, std::size_t key) {
+    for (auto [it, end] = this->index.equal_range(key); it != end; ++it) {
+        const Entry &e = *it->second;
+        if (e.transform->len == len && same_limbs(e.value, d)) {
+            this->entries.splice(this->entries.begin(), this->entries, it->second);
+            return e.transform;
+        }
+    }
+    return nullptr;
+}
+
+//drop the least recently used entries until the rest fit in the capacity.
+void TransformCache::trim() {
+    while (this->bytes > this->limit) {
+        auto last = std::prev(this->entries.end());
+        for (auto [it, end] = this->index.equal_range(last->key); it != end; ++it) {
+            if (it->second == last) {
+                this->index.erase(it);
+                break;
+            }
+        }
+        this->bytes -= last->bytes;
+        this->entries.erase(last);
+    }
+}
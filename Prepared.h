@@ -0,0 +1,120 @@
+//
+//@brief: Definitions for PreparedInt and TransformCache, factors kept with their transforms.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_PREPARED_H
+#define BIGINT_PREPARED_H
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "BigInt.h"
+
+struct PreparedTransform;
+
+class PreparedInt {
+    /**
+     *  A factor of many products, such as a constant or a modulus, kept with the forward transforms
+     * of its magnitude. A product with it that reaches the transform tier runs one forward and one
+     * inverse transform per prime instead of two forward ones and an inverse, about a third less
+     * work. The transform for a length is made by the first product that needs it (or by prepare())
+     * and kept with the value, 24 bytes per point, the length being the power of two at or above the
+     * limbs of both factors. Shorter products take the usual tiers. The transforms are number
+     * theoretic whatever engine a * b uses, so the products are exact. Safe to share between threads.
+     */
+    friend class TransformCache;
+
+public:
+    explicit PreparedInt(const BigInt &);
+
+    explicit PreparedInt(BigInt &&);
+
+    PreparedInt(const PreparedInt &) = delete;
+
+    PreparedInt &operator=(const PreparedInt &) = delete;
+
+    const BigInt &value() const;
+
+    BigInt multiply(const BigInt &) const;
+
+    void prepare(std::size_t) const;
+
+    std::size_t transform_bytes() const;
+
+private:
+    typedef std::shared_ptr<const PreparedTransform> Transform;
+
+    BigInt x;
+    mutable std::mutex mu;                      // guards transforms
+    mutable std::vector<Transform> transforms;  // one per length used
+
+private:
+    Transform transform(std::size_t) const;
+
+    static BigInt product(const BigInt &, const BigInt &, const std::function<Transform(std::size_t)> &);
+};
+
+BigInt operator*(const BigInt &, const PreparedInt &);
+
+BigInt operator*(const PreparedInt &, const BigInt &);
+
+class TransformCache {
+    /**
+     *  Transforms of recurring factors kept by value, for factors nobody prepared by hand. multiply(a, b)
+     * looks up the transform of b at the length of the product, makes it when it is missing, and keeps
+     * it while it is among the most recently used ones that fit in capacity() bytes together. Entries
+     * are keyed by the magnitude of b and the length, so any object holding that value (of either
+     * sign) finds them. Products below the transform tier pass straight through. Safe to share
+     * between threads.
+     */
+public:
+    explicit TransformCache(std::size_t = std::size_t(256) << 20);
+
+    TransformCache(const TransformCache &) = delete;
+
+    TransformCache &operator=(const TransformCache &) = delete;
+
+    BigInt multiply(const BigInt &, const BigInt &);
+
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+    void set_capacity(std::size_t);
+
+    void clear();
+
+private:
+    struct Entry {
+        Limbs value;                                    // magnitude of the factor
+        std::size_t key;                                // hash of the value and the length
+        std::shared_ptr<const PreparedTransform> transform;
+        std::size_t bytes;                              // of the value and the transform
+    };
+
+    mutable std::mutex mu;
+    std::list<Entry> entries;                           // most recently used first
+    std::unordered_multimap<std::size_t, std::list<Entry>::iterator> index;
+    std::size_t bytes = 0;
+    std::size_t limit;
+
+private:
+    std::shared_ptr<const PreparedTransform> find(const BigInt &, std::size_t);
+
+    std::shared_ptr<const PreparedTransform> lookup(const Limbs &, std::size_t, std::size_t);
+
+    void trim();
+};
+
+
+#endif //BIGINT_PREPARED_H
@@ -0,0 +1,199 @@
+//
+//@brief: Implementations of the radix conversion engine used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Radix.h"
+#include "Divide.h"
+#include "Kernel.h"
+#include "Multiply.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+typedef std::uint64_t limb;
+typedef unsigned __int128 dlimb;
+typedef Limbs Nat;
+
+const std::size_t RADIX_THRESHOLD = 40;     // limbs (or chunks) below which conversion goes chunk by chunk
+const char DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+//the largest power of the base fitting in a limb, and how many digits it stands for.
+struct Chunk {
+    limb value;
+    std::size_t digits;
+};
+
+static Chunk chunk_of(int base) {
+    Chunk c{static_cast<limb>(base), 1};
+    while (c.value <= ~limb(0) / base) {
+        c.value *= base;
+        c.digits++;
+    }
+    return c;
+}
+
+static void nat_trim(Nat &a) {
+    while (!a.empty() && a.back() == 0) { a.pop_back(); }
+}
+
+static int nat_cmp(const Nat &a, const Nat &b) {
+    if (a.size() != b.size()) { return a.size() < b.size() ? -1 : 1; }
+    return kernel::cmp_n(a.data(), b.data(), a.size());
+}
+
+//append chunk^(2^i) to the tree.
+static void grow_tree(std::vector<Nat> &pow) {
+    const Nat &p = pow.back();
+    Nat sq(2 * p.size());
+    square_limbs(sq.data(), p.data(), p.size());
+    nat_trim(sq);
+    pow.push_back(std::move(sq));
+}
+
+static int digit_value(char ch) {
+    if (ch >= '0' && ch <= '9') { return ch - '0'; }
+    if (ch >= 'a' && ch <= 'z') { return ch - 'a' + 10; }
+    if (ch >= 'A' && ch <= 'Z') { return ch - 'A' + 10; }
+    return 36;
+}
+
+static void check_base(int base) {
+    if (base < 2 || base > 36) { throw "Invalid base."; }
+}
+
+//write a as exactly width digits (zero padded) at out, by repeated division by the chunk.
+static void write_basecase(Nat a, const Chunk &c, int base, char *out, std::size_t width) {
+    std::size_t pos = width;
+    while (!a.empty()) {
+        limb rem = kernel::divmod_1(a.data(), a.data(), a.size(), c.value);
+        nat_trim(a);
+        for (std::size_t j = 0; j < c.digits && pos > 0; j++) {
+            out[--pos] = DIGITS[rem % base];
+            rem /= base;
+        }
+    }
+    std::fill(out, out + pos, '0');
+}
+
+//write a < pow[k + 1] as exactly width digits, splitting it by pow[k] into two halves.
+static void write_digits(const Nat &a, const std::vector<Nat> &pow, std::ptrdiff_t k, const Chunk &c, int base,
+                         char *out, std::size_t width) {
+    if (k < 0 || a.size() < RADIX_THRESHOLD) {
+        write_basecase(a, c, base, out, width);
+        return;
+    }
+    const std::size_t half = c.digits << k;
+    Nat q, r;
+    divide_limbs(a, pow[k], q, r);
+//    The halves go to disjoint parts of out.
+    std::shared_ptr<ThreadPool> pool = task_pool(pow[k].size());
+    TaskGroup tasks(pool.get());
+    tasks.run([&] { write_digits(q, pow, k - 1, c, base, out, width - half); });
+    write_digits(r, pow, k - 1, c, base, out + width - half, half);
+    tasks.wait();
+}
+
+static Nat read_basecase(const char *s, std::size_t n, const Chunk &c, int base) {
+    Nat a;
+    std::size_t pos = 0;
+    std::size_t len = n % c.digits == 0 ? c.digits : n % c.digits;
+    while (pos < n) {
+        limb value = 0, scale = 1;
+        for (std::size_t j = 0; j < len; j++, pos++) {
+            int d = digit_value(s[pos]);
+            if (d >= base) { throw "Invalid number format."; }
+            value = value * base + d;
+            scale *= base;
+        }
+//        a = a * scale + value.
+        limb carry = value;
+        for (limb &x : a) {
+            dlimb cur = static_cast<dlimb>(x) * scale + carry;
+            x = static_cast<limb>(cur);
+            carry = static_cast<limb>(cur >> 64);
+        }
+        if (carry != 0) { a.push_back(carry); }
+        len = c.digits;
+    }
+    nat_trim(a);
+    return a;
+}
+
+//read n <= digits * 2^(k + 1) digits as high * pow[k] + low, low being the last digits * 2^k of them.
+static Nat read_digits(const char *s, std::size_t n, const std::vector<Nat> &pow, std::ptrdiff_t k,
+                       const Chunk &c, int base) {
+    if (k < 0 || n < RADIX_THRESHOLD * c.digits) { return read_basecase(s, n, c, base); }
+    const std::size_t half = c.digits << k;
+    if (n <= half) { return read_digits(s, n, pow, k - 1, c, base); }
+    Nat high, low;
+    std::shared_ptr<ThreadPool> pool = task_pool(pow[k].size());
+    TaskGroup tasks(pool.get());
+    tasks.run([&] { high = read_digits(s, n - half, pow, k - 1, c, base); });
+    low = read_digits(s + n - half, half, pow, k - 1, c, base);
+    tasks.wait();
+    if (high.empty()) { return low; }
+    Nat r(high.size() + pow[k].size() + 1, 0);
+    multiply_limbs(r.data(), high.data(), high.size(), pow[k].data(), pow[k].size());
+    kernel::add(r.data(), r.data(), r.size(), low.data(), low.size());
+    nat_trim(r);
+    return r;
+}
+
+std::string limbs_to_string(const Nat &a, int base) {
+    check_base(base);
+    if (a.empty()) { return "0"; }
+    const std::size_t bitlen = 64 * a.size() - __builtin_clzll(a.back());
+
+    if ((base & (base - 1)) == 0) {
+//        A power of two: every digit is a fixed group of bits.
+        const unsigned s = __builtin_ctz(base);
+        std::size_t n = (bitlen + s - 1) / s;
+        std::string out(n, '0');
+        for (std::size_t i = 0; i < n; i++) {
+            std::size_t bit = i * s, at = bit / 64;
+            limb v = a[at] >> (bit % 64);
+            if (bit % 64 + s > 64 && at + 1 < a.size()) { v |= a[at + 1] << (64 - bit % 64); }
+            out[n - 1 - i] = DIGITS[v & (base - 1)];
+        }
+        return out;
+    }
+
+    const Chunk c = chunk_of(base);
+    std::vector<Nat> pow(1, Nat(1, c.value));
+    while (nat_cmp(pow.back(), a) <= 0) { grow_tree(pow); }
+//    a < pow[k + 1], so it has at most digits * 2^(k + 1) digits.
+    const std::ptrdiff_t k = static_cast<std::ptrdiff_t>(pow.size()) - 2;
+    std::string out(c.digits << (k + 1), '0');
+    write_digits(a, pow, k, c, base, out.data(), out.size());
+    out.erase(0, std::min(out.find_first_not_of('0'), out.size() - 1));
+    return out;
+}
+
+void string_to_limbs(const char *s, std::size_t n, int base, Nat &a) {
+    check_base(base);
+    if (n == 0) { throw "Invalid number format."; }
+    a.clear();
+
+    if ((base & (base - 1)) == 0) {
+        const unsigned bits = __builtin_ctz(base);
+        a.assign((n * bits + 63) / 64, 0);
+        for (std::size_t i = 0; i < n; i++) {
+            int d = digit_value(s[n - 1 - i]);
+            if (d >= base) { throw "Invalid number format."; }
+            std::size_t bit = i * bits, at = bit / 64;
+            a[at] |= static_cast<limb>(d) << (bit % 64);
+            if (bit % 64 + bits > 64) { a[at + 1] |= static_cast<limb>(d) >> (64 - bit % 64); }
+        }
+        nat_trim(a);
+        return;
+    }
+
+    const Chunk c = chunk_of(base);
+    std::vector<Nat> pow(1, Nat(1, c.value));
+    while ((c.digits << pow.size()) < n) { grow_tree(pow); }
+    a = read_digits(s, n, pow, static_cast<std::ptrdiff_t>(pow.size()) - 1, c, base);
+}
@@ -0,0 +1,33 @@
+//
+//@brief: Definitions for the radix conversion engine used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_RADIX_H
+#define BIGINT_RADIX_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Memory.h"
+
+/**
+ *  Conversions between a magnitude (base 2^64 limbs, least significant limb first, no leading zero
+ * limbs) and its digits in any base from 2 to 36, using 0-9 then a-z (either case when parsing).
+ *  Power of two bases are a linear bit copy. The other bases pack as many digits as fit in a limb
+ * into one chunk and split long numbers by a tree of chunk^(2^i) powers, recursively dividing
+ * (printing) or multiplying (parsing) through the fast division and multiplication tiers, so a
+ * conversion costs O(M(n) log n) instead of O(n^2).
+ */
+std::string limbs_to_string(const Limbs &a, int base);
+
+//parse the digits s[0..n) (no sign), throw "Invalid number format." on anything else.
+void string_to_limbs(const char *s, std::size_t n, int base, Limbs &a);
+
+
+#endif //BIGINT_RADIX_H
@@ -0,0 +1,155 @@
+//
+//@brief: Implementations of the binary serialization of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "BigInt.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include "Stats.h"
+
+typedef BigInt::limb limb;
+
+const std::size_t LIMB_BYTES = sizeof(limb);
+const std::size_t MAX_HEADER_BYTES = 10;    // a 64 bit varint
+const std::size_t STREAM_CHUNK = 1 << 16;   // limbs read from a stream at a time
+
+//    The form: varint(count << 1 | sign) then count limbs of 8 little-endian bytes. The varint is
+//    LEB128, 7 bits per byte starting with the lowest, the top bit of a byte set when more follow.
+
+//write the varint of v to out, return its length.
+static std::size_t put_header(std::byte *out, std::uint64_t v) {
+    std::size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = static_cast<std::byte>(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = static_cast<std::byte>(v);
+    return n;
+}
+
+//the length of the varint of v.
+static std::size_t header_size(std::uint64_t v) {
+    return v < 0x80 ? 1 : (64 - __builtin_clzll(v) + 6) / 7;
+}
+
+//add byte number i of a varint to v, return whether another one follows.
+static bool take_header_byte(std::uint64_t &v, std::size_t i, std::byte b) {
+    const std::uint64_t bits = static_cast<std::uint64_t>(b) & 0x7f;
+    if (i == MAX_HEADER_BYTES - 1 && bits > 1) { throw "Invalid serialized BigInt."; }
+    v |= bits << (7 * i);
+    if ((static_cast<std::uint64_t>(b) & 0x80) == 0) { return false; }
+    if (i == MAX_HEADER_BYTES - 1) { throw "Invalid serialized BigInt."; }
+    return true;
+}
+
+//n limbs to their little-endian bytes, a plain copy on little-endian hosts.
+static void store_limbs(std::byte *to, const limb *from, std::size_t n) {
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(to, from, n * LIMB_BYTES);
+    } else {
+        for (std::size_t i = 0; i < n; i++) {
+            limb v = __builtin_bswap64(from[i]);
+            std::memcpy(to + i * LIMB_BYTES, &v, LIMB_BYTES);
+        }
+    }
+}
+
+//n limbs from their little-endian bytes.
+static void load_limbs(limb *to, const std::byte *from, std::size_t n) {
+    std::memcpy(to, from, n * LIMB_BYTES);
+    if constexpr (std::endian::native == std::endian::big) {
+        for (std::size_t i = 0; i < n; i++) { to[i] = __builtin_bswap64(to[i]); }
+    }
+}
+
+std::size_t BigInt::serialized_size() const {
+//    Bytes serialize() writes for this number.
+    const std::uint64_t header = static_cast<std::uint64_t>(this->limbs.size()) << 1 | (this->negative ? 1 : 0);
+    return header_size(header) + this->limbs.size() * LIMB_BYTES;
+}
+
+std::size_t BigInt::serialize(std::span<std::byte> out) const {
+//    Write the binary form to the front of out and return its length.
+    BIGINT_STAT_OP(Serialize, this->limbs.size());
+    const std::size_t n = this->limbs.size();
+    if (out.size() < this->serialized_size()) { throw "Buffer too small."; }
+    const std::size_t h = put_header(out.data(), static_cast<std::uint64_t>(n) << 1 | (this->negative ? 1 : 0));
+    store_limbs(out.data() + h, this->limbs.data(), n);
+    return h + n * LIMB_BYTES;
+}
+
+void BigInt::serialize(std::ostream &out) const {
+//    The limbs go to the stream from their own storage on little-endian hosts.
+    BIGINT_STAT_OP(Serialize, this->limbs.size());
+    std::byte header[MAX_HEADER_BYTES];
+    const std::size_t n = this->limbs.size();
+    const std::size_t h = put_header(header, static_cast<std::uint64_t>(n) << 1 | (this->negative ? 1 : 0));
+    out.write(reinterpret_cast<const char *>(header), static_cast<std::streamsize>(h));
+    if constexpr (std::endian::native == std::endian::little) {
+        out.write(reinterpret_cast<const char *>(this->limbs.data()), static_cast<std::streamsize>(n * LIMB_BYTES));
+    } else {
+        std::byte chunk[256 * LIMB_BYTES];
+        for (std::size_t i = 0; i < n; i += 256) {
+            const std::size_t k = std::min<std::size_t>(256, n - i);
+            store_limbs(chunk, this->limbs.data() + i, k);
+            out.write(reinterpret_cast<const char *>(chunk), static_cast<std::streamsize>(k * LIMB_BYTES));
+        }
+    }
+}
+
+std::size_t BigInt::deserialize(std::span<const std::byte> in, BigInt &x) {
+//    Read the value at the front of in into x, reusing its storage, and return the bytes it took.
+    std::uint64_t header = 0;
+    std::size_t h = 0;
+    for (bool more = true; more; h++) {
+        if (h == in.size()) { throw "Truncated serialized BigInt."; }
+        more = take_header_byte(header, h, in[h]);
+    }
+    const std::uint64_t n = header >> 1;
+//    The length is checked against the bytes there before any storage is taken for it.
+    if (n > (in.size() - h) / LIMB_BYTES) { throw "Truncated serialized BigInt."; }
+    BIGINT_STAT_OP(Deserialize, n);
+    x.limbs.resize_for_overwrite(n);
+    load_limbs(x.limbs.data(), in.data() + h, n);
+    x.negative = (header & 1) != 0;
+    x.normalize();
+    return h + n * LIMB_BYTES;
+}
+
+void BigInt::deserialize(std::istream &in, BigInt &x) {
+//    Read one value from the stream into x. The limbs are read a chunk at a time, so a damaged
+//    length runs into the end of the stream before it takes all of its storage, and into storage of
+//    their own, so that x is left as it was when the stream is cut off, as with the span overload.
+    std::uint64_t header = 0;
+    for (std::size_t h = 0;; h++) {
+        char c;
+        if (!in.get(c)) { throw "Truncated serialized BigInt."; }
+        if (!take_header_byte(header, h, static_cast<std::byte>(c))) { break; }
+    }
+    const std::uint64_t n = header >> 1;
+    BIGINT_STAT_OP(Deserialize, n);
+    Limbs d;
+    for (std::uint64_t have = 0; have < n;) {
+        const std::size_t k = static_cast<std::size_t>(std::min<std::uint64_t>(STREAM_CHUNK, n - have));
+        d.resize(have + k);
+        limb *p = d.data() + have;
+        if (!in.read(reinterpret_cast<char *>(p), static_cast<std::streamsize>(k * LIMB_BYTES))) {
+            throw "Truncated serialized BigInt.";
+        }
+        if constexpr (std::endian::native == std::endian::big) {
+            for (std::size_t i = 0; i < k; i++) { p[i] = __builtin_bswap64(p[i]); }
+        }
+        have += k;
+    }
+    x.limbs.swap(d);
+    x.negative = (header & 1) != 0;
+    x.normalize();
+}
@@ -0,0 +1,171 @@
+//
+//@brief: Implementations of the opt-in instrumentation of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Stats.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace stats {
+    const int OPS = static_cast<int>(Op::Count);
+    const int TIERS = static_cast<int>(Tier::Count);
+
+    struct AtomicOp {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> ns{0};
+        std::atomic<std::uint64_t> sizes[HISTOGRAM_BUCKETS] = {};
+    };
+
+    struct AtomicTier {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> ns{0};
+    };
+
+    static AtomicOp op_counters[OPS];
+    static AtomicTier tier_counters[TIERS];
+    static std::atomic<std::uint64_t> bytes(0);
+
+    static const char *const OP_NAMES[OPS] = {
+            "add", "sub", "mul", "div", "mod", "pow", "square", "divide", "powmod", "mulmod", "compare", "parse", "print", "batch",
+            "serialize", "deserialize", "expression"
+    };
+    static const char *const TIER_NAMES[TIERS] = {
+            "basecase", "karatsuba", "toom3", "unbalanced", "fft", "ntt", "knuth", "burnikel_ziegler"
+    };
+
+    static const bool from_environment = [] {
+//        BIGINT_STATS=1 in the environment turns the counters on from start up.
+        const char *env = std::getenv("BIGINT_STATS");
+        if (env != nullptr && std::strcmp(env, "1") == 0) { active.store(true, std::memory_order_relaxed); }
+        return true;
+    }();
+
+    void enable(bool on) {
+        active.store(on, std::memory_order_relaxed);
+    }
+
+    bool enabled() {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    const char *name(Op op) {
+        return OP_NAMES[static_cast<int>(op)];
+    }
+
+    const char *name(Tier tier) {
+        return TIER_NAMES[static_cast<int>(tier)];
+    }
+
+    void record_op(Op op, std::size_t limbs, std::uint64_t ns) {
+        AtomicOp &c = op_counters[static_cast<int>(op)];
+        int bucket = limbs == 0 ? 0 : 64 - __builtin_clzll(limbs);
+        c.calls.fetch_add(1, std::memory_order_relaxed);
+        c.ns.fetch_add(ns, std::memory_order_relaxed);
+        c.sizes[bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void record_tier(Tier tier, std::uint64_t ns) {
+        AtomicTier &c = tier_counters[static_cast<int>(tier)];
+        c.calls.fetch_add(1, std::memory_order_relaxed);
+        c.ns.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    void record_allocation(std::size_t n) {
+        bytes.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() {
+//        Every counter is read on its own, so a snapshot taken under load is not an atomic cut.
+        Snapshot s;
+        for (int i = 0; i < OPS; i++) {
+            s.ops[i].calls = op_counters[i].calls.load(std::memory_order_relaxed);
+            s.ops[i].ns = op_counters[i].ns.load(std::memory_order_relaxed);
+            for (int j = 0; j < HISTOGRAM_BUCKETS; j++) {
+                s.ops[i].sizes[j] = op_counters[i].sizes[j].load(std::memory_order_relaxed);
+            }
+        }
+        for (int i = 0; i < TIERS; i++) {
+            s.tiers[i].calls = tier_counters[i].calls.load(std::memory_order_relaxed);
+            s.tiers[i].ns = tier_counters[i].ns.load(std::memory_order_relaxed);
+        }
+        s.bytes_allocated = bytes.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void reset() {
+        for (AtomicOp &c : op_counters) {
+            c.calls.store(0, std::memory_order_relaxed);
+            c.ns.store(0, std::memory_order_relaxed);
+            for (auto &x : c.sizes) { x.store(0, std::memory_order_relaxed); }
+        }
+        for (AtomicTier &c : tier_counters) {
+            c.calls.store(0, std::memory_order_relaxed);
+            c.ns.store(0, std::memory_order_relaxed);
+        }
+        bytes.store(0, std::memory_order_relaxed);
+    }
+
+//    smallest operand length of a histogram bucket.
+    static std::uint64_t bucket_floor(int bucket) {
+        return bucket == 0 ? 0 : std::uint64_t(1) << (bucket - 1);
+    }
+
+    std::string Snapshot::text() const {
+        std::string out;
+        char line[256];
+        std::snprintf(line, sizeof line, "%-16s %14s %16s  %s\n", "op", "calls", "ns", "limbs: calls");
+        out += line;
+        for (int i = 0; i < OPS; i++) {
+            if (ops[i].calls == 0) { continue; }
+            std::snprintf(line, sizeof line, "%-16s %14llu %16llu ", OP_NAMES[i],
+                          static_cast<unsigned long long>(ops[i].calls), static_cast<unsigned long long>(ops[i].ns));
+            out += line;
+            for (int j = 0; j < HISTOGRAM_BUCKETS; j++) {
+                if (ops[i].sizes[j] == 0) { continue; }
+                std::snprintf(line, sizeof line, " %llu+: %llu", static_cast<unsigned long long>(bucket_floor(j)),
+                              static_cast<unsigned long long>(ops[i].sizes[j]));
+                out += line;
+            }
+            out += '\n';
+        }
+        std::snprintf(line, sizeof line, "%-16s %14s %16s\n", "tier", "calls", "ns");
+        out += line;
+        for (int i = 0; i < TIERS; i++) {
+            if (tiers[i].calls == 0) { continue; }
+            std::snprintf(line, sizeof line, "%-16s %14llu %16llu\n", TIER_NAMES[i],
+                          static_cast<unsigned long long>(tiers[i].calls), static_cast<unsigned long long>(tiers[i].ns));
+            out += line;
+        }
+        std::snprintf(line, sizeof line, "bytes allocated %llu\n", static_cast<unsigned long long>(bytes_allocated));
+        out += line;
+        return out;
+    }
+
+    std::string Snapshot::json() const {
+        std::string out = "{\"ops\": {";
+        for (int i = 0; i < OPS; i++) {
+            out += (i ? ", \"" : "\"") + std::string(OP_NAMES[i]) + "\": {\"calls\": " + std::to_string(ops[i].calls)
+                   + ", \"ns\": " + std::to_string(ops[i].ns) + ", \"histogram\": {";
+            bool first = true;
+            for (int j = 0; j < HISTOGRAM_BUCKETS; j++) {
+                if (ops[i].sizes[j] == 0) { continue; }
+                out += (first ? "\"" : ", \"") + std::to_string(bucket_floor(j)) + "\": " + std::to_string(ops[i].sizes[j]);
+                first = false;
+            }
+            out += "}}";
+        }
+        out += "}, \"tiers\": {";
+        for (int i = 0; i < TIERS; i++) {
+            out += (i ? ", \"" : "\"") + std::string(TIER_NAMES[i]) + "\": {\"calls\": " + std::to_string(tiers[i].calls)
+                   + ", \"ns\": " + std::to_string(tiers[i].ns) + "}";
+        }
+        out += "}, \"bytes_allocated\": " + std::to_string(bytes_allocated) + "}";
+        return out;
+    }
+}
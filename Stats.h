@@ -0,0 +1,188 @@
+//
+//@brief: Definitions for the opt-in instrumentation of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_STATS_H
+#define BIGINT_STATS_H
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace stats {
+    /**
+     *  Counters of the public operations and of the algorithm tiers behind them. The hooks are compiled
+     * in when BIGINT_STATS is defined (the CMake option of the same name, on by default) and record
+     * nothing until enable(true) is called or the BIGINT_STATS environment variable is set to 1, so
+     * the cost when off is one relaxed load and a branch per call; without the definition they vanish.
+     *  Operations are counted once at the public boundary (pow's inner products are not multiplications
+     * of their own, the assignment of a lazy expression is one Expression) with the time they took and
+     * a histogram of the larger operand length. Tiers are counted at every call, recursion included,
+     * with their exclusive time: nested tiers are charged to themselves. Bytes allocated covers the
+     * limb storage of results and of the tiers' scratch.
+     */
+    enum class Op {
+        Add, Sub, Mul, Div, Mod, Pow, Square, Divide, PowMod, MulMod, Compare, Parse, Print, Batch,
+        Serialize, Deserialize, Expression, Count
+    };
+
+    enum class Tier {
+        Basecase, Karatsuba, Toom3, Unbalanced, FFT, NTT, Knuth, BurnikelZiegler, Count
+    };
+
+    const int HISTOGRAM_BUCKETS = 33;   // bucket 0 is zero limbs, bucket i > 0 is [2^(i-1), 2^i) limbs
+
+    struct OpCounters {
+        std::uint64_t calls = 0;
+        std::uint64_t ns = 0;
+        std::uint64_t sizes[HISTOGRAM_BUCKETS] = {};
+    };
+
+    struct TierCounters {
+        std::uint64_t calls = 0;
+        std::uint64_t ns = 0;
+    };
+
+    struct Snapshot {
+        OpCounters ops[static_cast<int>(Op::Count)];
+        TierCounters tiers[static_cast<int>(Tier::Count)];
+        std::uint64_t bytes_allocated = 0;
+
+        std::string text() const;
+
+        std::string json() const;
+    };
+
+    void enable(bool);
+
+    bool enabled();
+
+    Snapshot snapshot();
+
+    void reset();
+
+    const char *name(Op);
+
+    const char *name(Tier);
+
+    void record_op(Op, std::size_t, std::uint64_t);
+
+    void record_tier(Tier, std::uint64_t);
+
+    void record_allocation(std::size_t);
+
+    inline std::atomic<bool> active(false);
+
+    inline std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+        const auto d = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    }
+
+    class OpScope {
+//        Counts the outermost public operation of the calling thread.
+        friend class TaskScope;
+        static inline thread_local int depth = 0;
+        Op op;
+        std::size_t limbs;
+        bool entered = false;
+        bool counted = false;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        OpScope(Op o, std::size_t n) : op(o), limbs(n) {
+            if (!active.load(std::memory_order_relaxed)) { return; }
+            entered = true;
+            if (depth++ == 0) {
+                counted = true;
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~OpScope() {
+            if (!entered) { return; }
+            depth--;
+            if (counted) { record_op(op, limbs, elapsed_ns(start)); }
+        }
+
+        OpScope(const OpScope &) = delete;
+
+        OpScope &operator=(const OpScope &) = delete;
+    };
+
+    class TierScope {
+//        Times one tier call, handing its time over to the enclosing tier call of the thread.
+        friend class TaskScope;
+        static inline thread_local TierScope *current = nullptr;
+        Tier tier;
+        bool on;
+        TierScope *parent = nullptr;
+        std::uint64_t children = 0;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit TierScope(Tier t) : tier(t), on(active.load(std::memory_order_relaxed)) {
+            if (!on) { return; }
+            parent = current;
+            current = this;
+            start = std::chrono::steady_clock::now();
+        }
+
+        ~TierScope() {
+            if (!on) { return; }
+            std::uint64_t ns = elapsed_ns(start);
+            record_tier(tier, ns > children ? ns - children : 0);
+            if (parent != nullptr) { parent->children += ns; }
+            current = parent;
+        }
+
+        TierScope(const TierScope &) = delete;
+
+        TierScope &operator=(const TierScope &) = delete;
+    };
+
+    class TaskScope {
+//        Runs a pool task as if its thread were idle, also when it runs inside the wait() of another
+//        operation: the operations of the task are counted and its tiers keep their own time.
+        int depth;
+        TierScope *current;
+
+    public:
+        TaskScope() : depth(OpScope::depth), current(TierScope::current) {
+            OpScope::depth = 0;
+            TierScope::current = nullptr;
+        }
+
+        ~TaskScope() {
+            OpScope::depth = depth;
+            TierScope::current = current;
+        }
+
+        TaskScope(const TaskScope &) = delete;
+
+        TaskScope &operator=(const TaskScope &) = delete;
+    };
+}
+
+#ifdef BIGINT_STATS
+#define BIGINT_STAT_OP(op, limbs) stats::OpScope bigint_stat_op_(stats::Op::op, limbs)
+#define BIGINT_STAT_TIER(tier) stats::TierScope bigint_stat_tier_(stats::Tier::tier)
+#define BIGINT_STAT_TASK() stats::TaskScope bigint_stat_task_
+#define BIGINT_STAT_ALLOC(bytes) \
+    do { if (stats::active.load(std::memory_order_relaxed)) { stats::record_allocation(bytes); } } while (0)
+#else
+#define BIGINT_STAT_OP(op, limbs) ((void)0)
+#define BIGINT_STAT_TIER(tier) ((void)0)
+#define BIGINT_STAT_TASK() ((void)0)
+#define BIGINT_STAT_ALLOC(bytes) ((void)0)
+#endif
+
+
+#endif //BIGINT_STATS_H
@@ -0,0 +1,234 @@
+//
+//@brief: Implementations of the work-stealing pool running the parallel parts of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "ThreadPool.h"
+#include "BigInt.h"
+#include "Stats.h"
+#include <algorithm>
+#include <cstdlib>
+
+//the pool the calling thread works for and its queue there, if it is a worker.
+static thread_local const ThreadPool *worker_pool = nullptr;
+static thread_local std::size_t worker_queue = 0;
+
+ThreadPool::ThreadPool(unsigned threads) {
+    threads = std::max(threads, 1u);
+    for (unsigned i = 0; i < threads; i++) { queues.push_back(std::make_unique<Queue>()); }
+    for (unsigned i = 1; i < threads; i++) { workers.emplace_back([this, i] { work(i); }); }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mu);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : workers) { t.join(); }
+}
+
+unsigned ThreadPool::size() const {
+    return static_cast<unsigned>(workers.size()) + 1;
+}
+
+std::size_t ThreadPool::own_queue() const {
+    return worker_pool == this ? worker_queue : 0;
+}
+
+void ThreadPool::work(std::size_t index) {
+    worker_pool = this;
+    worker_queue = index;
+    while (true) {
+        if (run_one()) { continue; }
+        std::unique_lock<std::mutex> lock(sleep_mu);
+        wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) { return; }
+    }
+}
+
+void ThreadPool::push(std::function<void()> task) {
+    Queue &q = *queues[own_queue()];
+    {
+        std::lock_guard<std::mutex> lock(q.mu);
+        q.tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+//    Taking the lock orders the push before a worker that is about to sleep checks the count.
+    { std::lock_guard<std::mutex> lock(sleep_mu); }
+    wake.notify_one();
+}
+
+bool ThreadPool::run_one() {
+//    Newest task of the own queue first, then the oldest task of every other queue in turn.
+    const std::size_t self = own_queue();
+    std::function<void()> task;
+    for (std::size_t k = 0; k < queues.size() && !task; k++) {
+        Queue &q = *queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(q.mu);
+        if (q.tasks.empty()) { continue; }
+        if (k == 0) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+        } else {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+    }
+    if (!task) { return false; }
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    BIGINT_STAT_TASK();
+    task();
+    return true;
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)> &body) {
+    if (count <= 1 || workers.empty()) {
+        for (std::size_t i = 0; i < count; i++) { body(i); }
+        return;
+    }
+//    Indices are claimed one at a time, so uneven bodies still balance across the threads.
+    std::atomic<std::size_t> next(0);
+    auto claim = [&] {
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) { body(i); }
+    };
+    TaskGroup tasks(this);
+    for (std::size_t i = 1; i < std::min<std::size_t>(count, size()); i++) { tasks.run(claim); }
+    claim();
+    tasks.wait();
+}
+
+void ThreadPool::invoke(const std::function<void()> &f, const std::function<void()> &g) {
+    TaskGroup tasks(workers.empty() ? nullptr : this);
+    tasks.run(f);
+    g();
+    tasks.wait();
+}
+
+TaskGroup::TaskGroup(ThreadPool *p) : pool(p != nullptr && p->size() > 1 ? p : nullptr) {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+//        Only an unwinding scope gets here without having waited, its own exception wins.
+    }
+}
+
+void TaskGroup::spawn(std::function<void()> task) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool->push([this, task = std::move(task)] {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mu);
+            if (!error) { error = std::current_exception(); }
+        }
+//        The group may be gone once the count drops to zero, so only the pool is touched after it.
+        ThreadPool *p = pool;
+        bool notify;
+        {
+            std::lock_guard<std::mutex> lock(p->sleep_mu);
+            const bool asleep = sleeping;
+            notify = pending.fetch_sub(1, std::memory_order_release) == 1 && asleep;
+        }
+        if (notify) { p->wake.notify_all(); }
+    });
+}
+
+void TaskGroup::wait() {
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (pool->run_one()) { continue; }
+//        Nothing to run: sleep until a task is queued or the last task of the group is done.
+        std::unique_lock<std::mutex> lock(pool->sleep_mu);
+        sleeping = true;
+        pool->wake.wait(lock, [this] {
+            return pending.load(std::memory_order_acquire) == 0 || pool->queued.load(std::memory_order_acquire) > 0;
+        });
+        sleeping = false;
+    }
+    std::exception_ptr e;
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        std::swap(e, error);
+    }
+    if (e) { std::rethrow_exception(e); }
+}
+
+static std::mutex pool_mu;
+static std::shared_ptr<ThreadPool> pool;
+static bool pool_supplied = false;
+static std::atomic<std::size_t> cutoff(512);
+static unsigned pool_threads = [] {
+//    BIGINT_THREADS in the environment overrides the default of one thread per core.
+    const char *env = std::getenv("BIGINT_THREADS");
+    long n = env != nullptr ? std::strtol(env, nullptr, 10) : 0;
+    return n > 0 ? static_cast<unsigned>(n) : std::max(std::thread::hardware_concurrency(), 1u);
+}();
+
+//what parallel_pool() last worked out, read at every fork without pool_mu until a setter clears it.
+static std::atomic<std::shared_ptr<ThreadPool>> published;
+static std::atomic<bool> fresh(false);
+
+//drop the published pool, under pool_mu, so the next fork works it out again.
+static void unpublish() {
+    fresh.store(false, std::memory_order_release);
+    published.store(nullptr, std::memory_order_release);
+}
+
+std::shared_ptr<ThreadPool> parallel_pool() {
+    if (fresh.load(std::memory_order_acquire)) { return published.load(std::memory_order_acquire); }
+    std::lock_guard<std::mutex> lock(pool_mu);
+    std::shared_ptr<ThreadPool> p;
+    if (pool_supplied) {
+        if (pool != nullptr && pool->size() > 1) { p = pool; }
+    } else if (pool_threads > 1) {
+        if (!pool) { pool = std::make_shared<ThreadPool>(pool_threads); }
+        p = pool;
+    }
+    published.store(p, std::memory_order_release);
+    fresh.store(true, std::memory_order_release);
+    return p;
+}
+
+std::shared_ptr<ThreadPool> task_pool(std::size_t limbs) {
+    if (limbs < cutoff.load(std::memory_order_relaxed)) { return nullptr; }
+    return parallel_pool();
+}
+
+void BigInt::set_thread_count(unsigned n) {
+//    0 means one thread per core. The pool is started by the first fork that needs it, with n - 1
+//    workers; work already running keeps the pool it started with.
+    std::lock_guard<std::mutex> lock(pool_mu);
+    n = n == 0 ? std::max(std::thread::hardware_concurrency(), 1u) : n;
+    if (pool_supplied || n != pool_threads) { pool.reset(); }
+    pool_supplied = false;
+    pool_threads = n;
+    unpublish();
+}
+
+unsigned BigInt::thread_count() {
+    std::lock_guard<std::mutex> lock(pool_mu);
+    if (pool_supplied) { return pool != nullptr ? pool->size() : 1; }
+    return pool_threads;
+}
+
+void BigInt::set_thread_pool(std::shared_ptr<ThreadPool> p) {
+//    Run on the host's pool from now on, a null pool runs everything on the calling thread.
+    std::lock_guard<std::mutex> lock(pool_mu);
+    pool = std::move(p);
+    pool_supplied = true;
+    unpublish();
+}
+
+void BigInt::set_parallel_cutoff(std::size_t limbs) {
+    cutoff.store(std::max<std::size_t>(limbs, 1), std::memory_order_relaxed);
+}
+
+std::size_t BigInt::parallel_cutoff() {
+    return cutoff.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,122 @@
+//
+//@brief: Definitions for the work-stealing pool running the parallel parts of BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_THREADPOOL_H
+#define BIGINT_THREADPOOL_H
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ThreadPool {
+    /**
+     *  A work-stealing scheduler for fork-join work. Every worker owns a deque: tasks spawned on a
+     * worker go to the back of its own deque and it takes them back from there (the most recent,
+     * cache-warm subproblem first), while idle workers steal from the front of the others (the
+     * oldest, largest subproblem). Threads outside the pool spawn into a shared deque of their own.
+     *  size() counts the calling thread too, since a thread waiting for its tasks runs queued tasks
+     * meanwhile and only sleeps once there is nothing left to take; this is also why nested fork-join
+     * never deadlocks. Idle workers sleep as well, so a pool costs no CPU time while unused.
+     *  A host can build one pool, hand it to BigInt::set_thread_pool() and spawn its own TaskGroups
+     * on it, so BigInt never runs more threads than the host asked for.
+     */
+    friend class TaskGroup;
+
+public:
+    explicit ThreadPool(unsigned threads);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const;
+
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)> &body);
+
+    void invoke(const std::function<void()> &, const std::function<void()> &);
+
+private:
+    struct Queue {
+        std::mutex mu;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;     // queues[0] is shared by outside threads, queues[i] is worker i's
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queued{0};
+    std::mutex sleep_mu;
+    std::condition_variable wake;
+    bool stopping = false;
+
+private:
+    void work(std::size_t);
+
+    std::size_t own_queue() const;
+
+    void push(std::function<void()>);
+
+    bool run_one();
+};
+
+class TaskGroup {
+    /**
+     *  Tasks forked by one parallel step. run() spawns a task on the pool (or runs it at once when
+     * there is no pool), wait() helps running queued tasks (of any group) until every task of the
+     * group is done, sleeping while there is none to take, and then rethrows the first exception one
+     * of them threw. The destructor waits too, so the tasks may refer to locals of the scope that
+     * forked them.
+     */
+public:
+    explicit TaskGroup(ThreadPool *);
+
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    template<class F>
+    void run(F &&task) {
+//        Without a pool the task runs in place, with no std::function to allocate.
+        if (pool == nullptr) { task(); }
+        else { spawn(std::function<void()>(std::forward<F>(task))); }
+    }
+
+    void wait();
+
+private:
+    ThreadPool *pool;
+    std::atomic<std::size_t> pending{0};
+    bool sleeping = false;      // wait() is asleep, guarded by the pool's sleep_mu
+    std::mutex mu;
+    std::exception_ptr error;
+
+private:
+    void spawn(std::function<void()>);
+};
+
+//the pool of BigInt::set_thread_pool() or set_thread_count(), null while it is a single thread.
+std::shared_ptr<ThreadPool> parallel_pool();
+
+//the pool to fork subproblems of the given length in limbs onto, null below BigInt::parallel_cutoff().
+std::shared_ptr<ThreadPool> task_pool(std::size_t);
+
+
+#endif //BIGINT_THREADPOOL_H
@@ -0,0 +1,692 @@
+//
+//@brief: Implementations of the transform based multiplication engines used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#include "Transform.h"
+#include "Stats.h"
+#include "Kernel.h"
+#include "Memory.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <string_view>
+
+typedef std::uint64_t limb;
+typedef unsigned __int128 dlimb;
+
+const double PI(acos(-1.0));
+const std::size_t FFT_BLOCK = 1 << 11;      // points a transform runs stage after stage, 32 KiB
+const std::size_t FFT_PARALLEL = 1 << 15;   // points of the pieces a pool hands out whole
+const std::size_t FFT_WIDE = 1 << 15;       // longest transform of 16-bit coefficients
+const std::size_t TWIDDLE_KEEP = 1 << 20;   // points of the largest root table kept, 24 MiB
+
+//    The complex FFT keeps the real and the imaginary parts in arrays of their own, so the
+//    butterfly loops vectorize over consecutive points. The forward transform decimates in
+//    frequency (natural order in, bit reversed order out) and the inverse in time (bit reversed in,
+//    natural out), so the pointwise product works on bit reversed spectra and nothing is permuted.
+//    Every pass does two stages (radix 4). A transform longer than FFT_BLOCK makes its first pass
+//    over the whole array and then recurses into the quarters, so the narrower stages run on pieces
+//    already in cache and the array goes through memory once per two wide stages.
+
+//e^(-2 pi i j / 2h) at [h + j] for every half length h below len, and the cube e^(-2 pi i 3j / 4q)
+//the radix 4 pass of quarter length q needs at [q + j] of re3, im3.
+struct Twiddles {
+    std::size_t len;
+    std::vector<double> re, im, re3, im3;
+
+    explicit Twiddles(std::size_t size)
+            : len(std::max<std::size_t>(size, 8)), re(len), im(len), re3(len / 2), im3(len / 2) {
+//        Every root of the top stage takes its own sine and cosine of an angle in the first octant,
+//        so none inherits the error of another and the roots on the axes are exact.
+        const std::size_t h = len / 2, q = len / 4;
+        for (std::size_t k = 0; k <= len / 8; k++) {
+            const double t = 2 * PI * static_cast<double>(k) / static_cast<double>(len), c = cos(t), s = sin(t);
+            set(h + k, c, -s);
+            set(h + q - k, s, -c);
+            if (k > 0) {
+                set(h + q + k, -s, -c);
+                set(len - k, -c, -s);
+            }
+        }
+//        A stage uses every other root of the stage above it, and the cubes are roots of the top
+//        stage too, negated past the half turn: all of them are copies, none is a product.
+        for (std::size_t g = h / 2; g >= 1; g >>= 1) {
+            for (std::size_t j = 0; j < g; j++) { set(g + j, re[2 * (g + j)], im[2 * (g + j)]); }
+        }
+        for (std::size_t g = 1; g <= q; g <<= 1) {
+            for (std::size_t j = 0; j < g; j++) {
+                const std::size_t k = 3 * j * (q / g);
+                re3[g + j] = k < h ? re[h + k] : -re[k];
+                im3[g + j] = k < h ? im[h + k] : -im[k];
+            }
+        }
+    }
+
+    void set(std::size_t i, double x, double y) {
+        re[i] = x;
+        im[i] = y;
+    }
+};
+
+//the table for transforms of up to len points. The largest one built so far, up to TWIDDLE_KEEP
+//points, serves every shorter transform and is published for the calls after; a longer one is built
+//for its call alone and freed with it, so such a call also pays for building its table. Tables are
+//built without a lock, so two first calls may both build one.
+static std::shared_ptr<const Twiddles> twiddles(std::size_t len) {
+    static std::atomic<std::shared_ptr<const Twiddles>> cached;
+    std::shared_ptr<const Twiddles> seen = cached.load(std::memory_order_acquire);
+    if (seen != nullptr && seen->len >= len) { return seen; }
+    std::shared_ptr<const Twiddles> built = std::make_shared<const Twiddles>(len);
+    if (built->len <= TWIDDLE_KEEP) {
+        while ((seen == nullptr || seen->len < built->len) &&
+               !cached.compare_exchange_weak(seen, built, std::memory_order_acq_rel)) {}
+    }
+    return built;
+}
+
+//    The butterflies are written once and inlined into a copy per instruction set.
+
+//the decimation in frequency butterflies of stages 2q and q on the 4q points from re, im, for the
+//offsets j in [begin, end): x_k = a[j + kq] goes to (x0 + x2) + (x1 + x3), ((x0 + x2) - (x1 + x3)) w^2j,
+//((x0 - x2) - i(x1 - x3)) w^j and ((x0 - x2) + i(x1 - x3)) w^3j, where w = e^(-2 pi i / 4q).
+__attribute__((always_inline))
+static inline void dif4(double *re, double *im, std::size_t q, std::size_t begin, std::size_t end,
+                        const Twiddles &tw) {
+    double *r0 = re, *r1 = re + q, *r2 = re + 2 * q, *r3 = re + 3 * q;
+    double *i0 = im, *i1 = im + q, *i2 = im + 2 * q, *i3 = im + 3 * q;
+    const double *w1r = tw.re.data() + 2 * q, *w1i = tw.im.data() + 2 * q;
+    const double *w2r = tw.re.data() + q, *w2i = tw.im.data() + q;
+    const double *w3r = tw.re3.data() + q, *w3i = tw.im3.data() + q;
+#pragma GCC ivdep
+    for (std::size_t j = begin; j < end; j++) {
+        const double ar = r0[j] + r2[j], ai = i0[j] + i2[j], br = r0[j] - r2[j], bi = i0[j] - i2[j];
+        const double cr = r1[j] + r3[j], ci = i1[j] + i3[j], dr = i1[j] - i3[j], di = r3[j] - r1[j];
+        const double ur = ar - cr, ui = ai - ci, vr = br + dr, vi = bi + di, xr = br - dr, xi = bi - di;
+        r0[j] = ar + cr;
+        i0[j] = ai + ci;
+        r1[j] = ur * w2r[j] - ui * w2i[j];
+        i1[j] = ur * w2i[j] + ui * w2r[j];
+        r2[j] = vr * w1r[j] - vi * w1i[j];
+        i2[j] = vr * w1i[j] + vi * w1r[j];
+        r3[j] = xr * w3r[j] - xi * w3i[j];
+        i3[j] = xr * w3i[j] + xi * w3r[j];
+    }
+}
+
+//the decimation in time butterflies of stages q and 2q, undoing dif4 up to the factor 4: with
+//z_k = x_k conj(w^(2j, j, 3j)), (x0 + z1) +- (z2 + z3) go to 0 and 2q, (x0 - z1) +- i(z2 - z3) to q and 3q.
+__attribute__((always_inline))
+static inline void dit4(double *re, double *im, std::size_t q, std::size_t begin, std::size_t end,
+                        const Twiddles &tw) {
+    double *r0 = re, *r1 = re + q, *r2 = re + 2 * q, *r3 = re + 3 * q;
+    double *i0 = im, *i1 = im + q, *i2 = im + 2 * q, *i3 = im + 3 * q;
+    const double *w1r = tw.re.data() + 2 * q, *w1i = tw.im.data() + 2 * q;
+    const double *w2r = tw.re.data() + q, *w2i = tw.im.data() + q;
+    const double *w3r = tw.re3.data() + q, *w3i = tw.im3.data() + q;
+#pragma GCC ivdep
+    for (std::size_t j = begin; j < end; j++) {
+        const double z1r = r1[j] * w2r[j] + i1[j] * w2i[j], z1i = i1[j] * w2r[j] - r1[j] * w2i[j];
+        const double z2r = r2[j] * w1r[j] + i2[j] * w1i[j], z2i = i2[j] * w1r[j] - r2[j] * w1i[j];
+        const double z3r = r3[j] * w3r[j] + i3[j] * w3i[j], z3i = i3[j] * w3r[j] - r3[j] * w3i[j];
+        const double ur = r0[j] + z1r, ui = i0[j] + z1i, br = r0[j] - z1r, bi = i0[j] - z1i;
+        const double vr = z2r + z3r, vi = z2i + z3i, dr = z2r - z3r, di = z2i - z3i;
+        r0[j] = ur + vr;
+        i0[j] = ui + vi;
+        r2[j] = ur - vr;
+        i2[j] = ui - vi;
+        r1[j] = br - di;
+        i1[j] = bi + dr;
+        r3[j] = br + di;
+        i3[j] = bi - dr;
+    }
+}
+
+//the stage of half length 1, left over when len is an odd power of two. Its root is 1.
+__attribute__((always_inline))
+static inline void radix2(double *re, double *im, std::size_t len) {
+    for (std::size_t i = 0; i < len; i += 2) {
+        const double xr = re[i], xi = im[i], yr = re[i + 1], yi = im[i + 1];
+        re[i] = xr + yr;
+        im[i] = xi + yi;
+        re[i + 1] = xr - yr;
+        im[i + 1] = xi - yi;
+    }
+}
+
+//the stages of half length 2 and 1 on groups of four points, where every root is 1.
+__attribute__((always_inline))
+static inline void dif4_unit(double *re, double *im, std::size_t len) {
+    for (std::size_t i = 0; i < len; i += 4) {
+        const double ar = re[i] + re[i + 2], ai = im[i] + im[i + 2], br = re[i] - re[i + 2], bi = im[i] - im[i + 2];
+        const double cr = re[i + 1] + re[i + 3], ci = im[i + 1] + im[i + 3];
+        const double dr = im[i + 1] - im[i + 3], di = re[i + 3] - re[i + 1];
+        re[i] = ar + cr;
+        im[i] = ai + ci;
+        re[i + 1] = ar - cr;
+        im[i + 1] = ai - ci;
+        re[i + 2] = br + dr;
+        im[i + 2] = bi + di;
+        re[i + 3] = br - dr;
+        im[i + 3] = bi - di;
+    }
+}
+
+__attribute__((always_inline))
+static inline void dit4_unit(double *re, double *im, std::size_t len) {
+    for (std::size_t i = 0; i < len; i += 4) {
+        const double ur = re[i] + re[i + 1], ui = im[i] + im[i + 1], br = re[i] - re[i + 1], bi = im[i] - im[i + 1];
+        const double vr = re[i + 2] + re[i + 3], vi = im[i + 2] + im[i + 3];
+        const double dr = re[i + 2] - re[i + 3], di = im[i + 2] - im[i + 3];
+        re[i] = ur + vr;
+        im[i] = ui + vi;
+        re[i + 2] = ur - vr;
+        im[i + 2] = ui - vi;
+        re[i + 1] = br - di;
+        im[i + 1] = bi + dr;
+        re[i + 3] = br + di;
+        im[i + 3] = bi - dr;
+    }
+}
+
+//every stage of a transform of at most FFT_BLOCK points, in place.
+__attribute__((always_inline))
+static inline void forward_block(double *re, double *im, std::size_t len, const Twiddles &tw) {
+    std::size_t q = len / 4;
+    for (; q > 1; q /= 4) {
+        for (std::size_t i = 0; i < len; i += 4 * q) { dif4(re + i, im + i, q, 0, q, tw); }
+    }
+    if (q == 1) { dif4_unit(re, im, len); }
+    else { radix2(re, im, len); }
+}
+
+__attribute__((always_inline))
+static inline void inverse_block(double *re, double *im, std::size_t len, const Twiddles &tw) {
+    std::size_t q = 2;
+    if (std::countr_zero(len) % 2 == 0) {
+        dit4_unit(re, im, len);
+        q = 4;
+    } else { radix2(re, im, len); }
+    for (; 4 * q <= len; q *= 4) {
+        for (std::size_t i = 0; i < len; i += 4 * q) { dit4(re + i, im + i, q, 0, q, tw); }
+    }
+}
+
+//the spectra of two real operands packed as a + ib, in bit reversed order, to the spectrum of a * b,
+//or the spectrum of one real operand to that of its square, scaled by 1 / len for the inverse.
+__attribute__((always_inline))
+static inline void pointwise(double *re, double *im, std::size_t len, bool square) {
+    const double f = 1.0 / static_cast<double>(len);
+    if (square) {
+        for (std::size_t i = 0; i < len; i++) {
+            const double x = re[i], y = im[i];
+            re[i] = (x * x - y * y) * f;
+            im[i] = 2 * x * y * f;
+        }
+        return;
+    }
+//    With Z = A + iB, A(k) B(k) = (Z(k)^2 - conj(Z(-k))^2) / 4i, and the product at -k is the
+//    conjugate of the one at k. In bit reversed order 0 and 1 (the frequencies 0 and len / 2) are
+//    their own partners, and p in [s, 2s) pairs with 3s - 1 - p.
+    for (std::size_t p = 0; p < 2; p++) {
+        re[p] = re[p] * im[p] * f;
+        im[p] = 0;
+    }
+    for (std::size_t s = 2; s < len; s <<= 1) {
+        double *pr = re + s, *pi = im + s, *qr = re + s + s / 2, *qi = im + s + s / 2;
+        const std::size_t h = s / 2;
+#pragma GCC ivdep
+        for (std::size_t k = 0; k < h; k++) {
+            const double ar = pr[k], ai = pi[k], br = qr[h - 1 - k], bi = qi[h - 1 - k];
+            const double x = (ar * ai + br * bi) * (f / 2), y = (ar * ar - ai * ai - br * br + bi * bi) * (f / 4);
+            pr[k] = x;
+            pi[k] = -y;
+            qr[h - 1 - k] = x;
+            qi[h - 1 - k] = y;
+        }
+    }
+}
+
+struct FftKernels {
+    void (*dif4)(double *, double *, std::size_t, std::size_t, std::size_t, const Twiddles &);
+    void (*dit4)(double *, double *, std::size_t, std::size_t, std::size_t, const Twiddles &);
+    void (*forward)(double *, double *, std::size_t, const Twiddles &);
+    void (*inverse)(double *, double *, std::size_t, const Twiddles &);
+    void (*pointwise)(double *, double *, std::size_t, bool);
+};
+
+#define FFT_KERNELS(NAME, TARGET) \
+    TARGET static void dif4_##NAME(double *re, double *im, std::size_t q, std::size_t begin, std::size_t end, \
+                                   const Twiddles &tw) { \
+        dif4(re, im, q, begin, end, tw); \
+    } \
+    TARGET static void dit4_##NAME(double *re, double *im, std::size_t q, std::size_t begin, std::size_t end, \
+                                   const Twiddles &tw) { \
+        dit4(re, im, q, begin, end, tw); \
+    } \
+    TARGET static void forward_##NAME(double *re, double *im, std::size_t len, const Twiddles &tw) { \
+        if (len <= FFT_BLOCK) { \
+            forward_block(re, im, len, tw); \
+            return; \
+        } \
+        const std::size_t q = len / 4; \
+        dif4(re, im, q, 0, q, tw); \
+        for (std::size_t k = 0; k < 4; k++) { forward_##NAME(re + k * q, im + k * q, q, tw); } \
+    } \
+    TARGET static void inverse_##NAME(double *re, double *im, std::size_t len, const Twiddles &tw) { \
+        if (len <= FFT_BLOCK) { \
+            inverse_block(re, im, len, tw); \
+            return; \
+        } \
+        const std::size_t q = len / 4; \
+        for (std::size_t k = 0; k < 4; k++) { inverse_##NAME(re + k * q, im + k * q, q, tw); } \
+        dit4(re, im, q, 0, q, tw); \
+    } \
+    TARGET static void pointwise_##NAME(double *re, double *im, std::size_t len, bool square) { \
+        pointwise(re, im, len, square); \
+    }
+
+FFT_KERNELS(scalar, )
+#if defined(__x86_64__) || defined(__i386__)
+FFT_KERNELS(avx2, __attribute__((target("avx2,fma"))))
+FFT_KERNELS(avx512, __attribute__((target("avx512f,fma"))))
+#endif
+
+//the copy for the instruction set the limb kernels picked, so BIGINT_SIMD applies here too.
+static const FftKernels &fft_kernels() {
+    static const FftKernels selected = [] {
+        std::string_view level = kernel::simd_level();
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (level == "avx512") {
+            return FftKernels{dif4_avx512, dit4_avx512, forward_avx512, inverse_avx512, pointwise_avx512};
+        }
+        if (level == "avx2" && __builtin_cpu_supports("fma")) {
+            return FftKernels{dif4_avx2, dit4_avx2, forward_avx2, inverse_avx2, pointwise_avx2};
+        }
+#endif
+        return FftKernels{dif4_scalar, dit4_scalar, forward_scalar, inverse_scalar, pointwise_scalar};
+    }();
+    return selected;
+}
+
+//the forward transform of len points. Given a pool, the passes over pieces longer than
+//FFT_PARALLEL are cut into runs of butterflies across it, then every piece finishes on one thread.
+static void fft_forward(double *re, double *im, std::size_t len, const Twiddles &tw, ThreadPool *pool) {
+    const FftKernels &k = fft_kernels();
+    std::size_t size = len;
+    if (pool != nullptr) {
+        for (; size > FFT_PARALLEL; size /= 4) {
+            const std::size_t q = size / 4, run = FFT_PARALLEL / 4;
+            pool->parallel_for(len / FFT_PARALLEL, [&](std::size_t t) {
+                const std::size_t first = t * run, i = first / q * size;
+                k.dif4(re + i, im + i, q, first % q, first % q + run, tw);
+            });
+        }
+    }
+    if (size == len) { k.forward(re, im, len, tw); }
+    else { pool->parallel_for(len / size, [&](std::size_t t) { k.forward(re + t * size, im + t * size, size, tw); }); }
+}
+
+//the inverse of fft_forward up to the factor len, the same pieces in the reverse order.
+static void fft_inverse(double *re, double *im, std::size_t len, const Twiddles &tw, ThreadPool *pool) {
+    const FftKernels &k = fft_kernels();
+    std::size_t size = len;
+    if (pool != nullptr) {
+        while (size > FFT_PARALLEL) { size /= 4; }
+    }
+    if (size == len) {
+        k.inverse(re, im, len, tw);
+        return;
+    }
+    pool->parallel_for(len / size, [&](std::size_t t) { k.inverse(re + t * size, im + t * size, size, tw); });
+    for (size *= 4; size <= len; size *= 4) {
+        const std::size_t q = size / 4, run = FFT_PARALLEL / 4;
+        pool->parallel_for(len / FFT_PARALLEL, [&](std::size_t t) {
+            const std::size_t first = t * run, i = first / q * size;
+            k.dit4(re + i, im + i, q, first % q, first % q + run, tw);
+        });
+    }
+}
+
+void fft_multiply(const limb *a, std::size_t n, const limb *b, std::size_t m, limb *out, ThreadPool *pool) {
+//    Every limb is split into 16-bit coefficients up to FFT_WIDE points, where the rounding error
+//    of all-ones operands is still below 0.02, and into 8-bit ones beyond. Both operands go through
+//    one transform, a as the real part and b as the imaginary part, and pointwise() parts them.
+    const int bits = (n + m) * 4 <= FFT_WIDE ? 16 : 8;
+    const std::size_t per = 64 / bits;
+    const limb mask = (limb(1) << bits) - 1;
+    const std::size_t na = n * per, nb = m * per;
+    const bool square = a == b && n == m;
+    const std::size_t len = std::bit_ceil(na + nb - 1);
+    BIGINT_STAT_TIER(FFT);
+    const std::shared_ptr<const Twiddles> tw = twiddles(len);
+    memory::Scratch scratch;
+    double *re = scratch.take<double>(len), *im = scratch.take<double>(len);
+    BIGINT_STAT_ALLOC(2 * len * sizeof(double));
+    auto split = [&](double *x, const limb *y, std::size_t yn) {
+        for (std::size_t i = 0; i < yn; i++) {
+            for (std::size_t k = 0; k < per; k++) { x[i * per + k] = static_cast<double>((y[i] >> (bits * k)) & mask); }
+        }
+        std::fill(x + yn * per, x + len, 0.0);
+    };
+    split(re, a, n);
+    if (square) { std::fill(im, im + len, 0.0); }
+    else { split(im, b, m); }
+    fft_forward(re, im, len, *tw, pool);
+    fft_kernels().pointwise(re, im, len, square);
+    fft_inverse(re, im, len, *tw, pool);
+
+    dlimb carry = 0;
+    for (std::size_t i = 0; i < n + m; ++i) {
+        limb v = 0;
+        for (std::size_t k = 0; k < per; ++k) {
+//            The coefficients are not negative, so adding 0.5 and truncating rounds them.
+            if (i * per + k < len) { carry += static_cast<limb>(re[i * per + k] + 0.5); }
+            v |= static_cast<limb>(carry & mask) << (bits * k);
+            carry >>= bits;
+        }
+        out[i] = v;
+    }
+}
+
+//arithmetic modulo a 62-bit prime, values are kept in Montgomery form (x * 2^64 mod p).
+struct Modulus {
+    limb p;         // the prime
+    limb np;        // -p^-1 mod 2^64
+    limb r2;        // 2^128 mod p
+    limb g;         // a primitive root of p
+
+    Modulus(limb prime, limb root) : p(prime), g(root) {
+        limb inv = p;
+        for (int i = 0; i < 5; i++) { inv *= 2 - p * inv; }
+        np = -inv;
+        limb r1 = (0 - p) % p;
+        r2 = static_cast<limb>(static_cast<dlimb>(r1) * r1 % p);
+    }
+
+    limb reduce(dlimb t) const {
+        limb k = static_cast<limb>(t) * np;
+        limb u = static_cast<limb>((t + static_cast<dlimb>(k) * p) >> 64);
+        return u >= p ? u - p : u;
+    }
+
+    limb mul(limb a, limb b) const { return reduce(static_cast<dlimb>(a) * b); }
+
+    limb add(limb a, limb b) const { return a + b >= p ? a + b - p : a + b; }
+
+    limb sub(limb a, limb b) const { return a >= b ? a - b : a + p - b; }
+
+    limb to_mont(limb a) const { return mul(a % p, r2); }
+
+    limb pow(limb a, limb e) const {
+        limb result = to_mont(1);
+        for (; e; e >>= 1, a = mul(a, a)) {
+            if (e & 1) { result = mul(result, a); }
+        }
+        return result;
+    }
+
+    limb inverse(limb a) const { return pow(a, p - 2); }
+};
+
+static const Modulus MODULI[3] = {
+        Modulus(4179340454199820289ULL, 3),    // 29 * 2^57 + 1
+        Modulus(2485986994308513793ULL, 5),    // 69 * 2^55 + 1
+        Modulus(1945555039024054273ULL, 5),    // 27 * 2^56 + 1
+};
+
+const std::size_t NTT_BLOCK = 1 << 12;     // residues a thread works on at a time, 32 KiB
+
+//body(begin, end) over [0, n) in blocks spread across the pool, or in one piece without a pool.
+static void for_blocks(ThreadPool *pool, std::size_t n, const std::function<void(std::size_t, std::size_t)> &body) {
+    if (pool == nullptr || n <= NTT_BLOCK) {
+        body(0, n);
+        return;
+    }
+    pool->parallel_for((n + NTT_BLOCK - 1) / NTT_BLOCK, [&](std::size_t t) {
+        body(t * NTT_BLOCK, std::min(n, (t + 1) * NTT_BLOCK));
+    });
+}
+
+//fill roots[h + j] with w^j for every half length h, where w is a primitive (2h)-th root of unity.
+static void ntt_roots(limb *roots, std::size_t len, const Modulus &md, bool inverse, ThreadPool *pool) {
+    for (std::size_t h = 1; h < len; h <<= 1) {
+        limb w = md.pow(md.to_mont(md.g), (md.p - 1) / (2 * h));
+        if (inverse) { w = md.inverse(w); }
+        for_blocks(pool, h, [&](std::size_t begin, std::size_t end) {
+            limb cur = md.pow(w, begin);
+            for (std::size_t j = begin; j < end; j++) {
+                roots[h + j] = cur;
+                cur = md.mul(cur, w);
+            }
+        });
+    }
+}
+
+//decimation in frequency, natural order in and bit reversed order out.
+static void ntt_forward(limb *a, std::size_t len, const limb *roots, const Modulus &md, ThreadPool *pool) {
+    std::size_t h = len >> 1;
+    if (pool != nullptr && len > NTT_BLOCK) {
+//        The stages wider than a block are cut into runs of butterflies, after them every block
+//        only depends on itself and finishes its transform alone.
+        for (; 2 * h > NTT_BLOCK; h >>= 1) {
+            pool->parallel_for(len / NTT_BLOCK, [&](std::size_t t) {
+                std::size_t k = t * (NTT_BLOCK / 2), i = k / h * 2 * h;
+                for (std::size_t j = k % h; j < k % h + NTT_BLOCK / 2; j++) {
+                    limb u = a[i + j], v = a[i + j + h];
+                    a[i + j] = md.add(u, v);
+                    a[i + j + h] = md.mul(md.sub(u, v), roots[h + j]);
+                }
+            });
+        }
+        pool->parallel_for(len / NTT_BLOCK, [&](std::size_t t) {
+            ntt_forward(a + t * NTT_BLOCK, NTT_BLOCK, roots, md, nullptr);
+        });
+        return;
+    }
+    for (; h >= 1; h >>= 1) {
+        for (std::size_t i = 0; i < len; i += 2 * h) {
+            for (std::size_t j = 0; j < h; j++) {
+                limb u = a[i + j], v = a[i + j + h];
+                a[i + j] = md.add(u, v);
+                a[i + j + h] = md.mul(md.sub(u, v), roots[h + j]);
+            }
+        }
+    }
+}
+
+//decimation in time, bit reversed order in and natural order out, the result is scaled by len.
+static void ntt_inverse(limb *a, std::size_t len, const limb *roots, const Modulus &md, ThreadPool *pool) {
+    if (pool != nullptr && len > NTT_BLOCK) {
+        pool->parallel_for(len / NTT_BLOCK, [&](std::size_t t) {
+            ntt_inverse(a + t * NTT_BLOCK, NTT_BLOCK, roots, md, nullptr);
+        });
+        for (std::size_t h = NTT_BLOCK; h < len; h <<= 1) {
+            pool->parallel_for(len / NTT_BLOCK, [&](std::size_t t) {
+                std::size_t k = t * (NTT_BLOCK / 2), i = k / h * 2 * h;
+                for (std::size_t j = k % h; j < k % h + NTT_BLOCK / 2; j++) {
+                    limb u = a[i + j], v = md.mul(a[i + j + h], roots[h + j]);
+                    a[i + j] = md.add(u, v);
+                    a[i + j + h] = md.sub(u, v);
+                }
+            });
+        }
+        return;
+    }
+    for (std::size_t h = 1; h < len; h <<= 1) {
+        for (std::size_t i = 0; i < len; i += 2 * h) {
+            for (std::size_t j = 0; j < h; j++) {
+                limb u = a[i + j], v = md.mul(a[i + j + h], roots[h + j]);
+                a[i + j] = md.add(u, v);
+                a[i + j + h] = md.sub(u, v);
+            }
+        }
+    }
+}
+
+//Garner's recombination of the three residue vectors: x = r1 + p1 * t2 + p1 * p2 * t3.
+struct Garner {
+    const Modulus &m1 = MODULI[0], &m2 = MODULI[1], &m3 = MODULI[2];
+    const limb inv12 = m2.inverse(m2.to_mont(m1.p));                  // p1^-1 mod p2, Montgomery form
+    const limb inv123 = m3.inverse(m3.mul(m3.to_mont(m1.p), m3.to_mont(m2.p)));
+    const limb p1_mod3 = m3.to_mont(m1.p);
+    const limb p12_lo = static_cast<limb>(static_cast<dlimb>(m1.p) * m2.p);
+    const limb p12_hi = static_cast<limb>((static_cast<dlimb>(m1.p) * m2.p) >> 64);
+
+//    write out[begin..end) of the sum of the coefficients from begin on, return the carry past end.
+    dlimb run(const limb *res, std::size_t len, limb *out, std::size_t begin, std::size_t end) const {
+        limb c0 = 0, c1 = 0;    // carry into the next position, below 2^128
+        for (std::size_t i = begin; i < end; i++) {
+            limb s0 = c0, s1 = c1, s2 = 0;
+            if (i < len) {
+                limb r1 = res[i], r2 = res[len + i], r3 = res[2 * len + i];
+                limb t2 = m2.mul(m2.sub(r2, r1 % m2.p), inv12);
+                limb x12_mod3 = m3.add(r1 % m3.p, m3.mul(t2 % m3.p, p1_mod3));
+                limb t3 = m3.mul(m3.sub(r3, x12_mod3), inv123);
+
+                dlimb lo = static_cast<dlimb>(p12_lo) * t3;
+                dlimb hi = static_cast<dlimb>(p12_hi) * t3 + static_cast<limb>(lo >> 64);
+                dlimb x12 = static_cast<dlimb>(m1.p) * t2 + r1;
+
+                dlimb acc = static_cast<dlimb>(s0) + static_cast<limb>(lo) + static_cast<limb>(x12);
+                s0 = static_cast<limb>(acc);
+                acc = (acc >> 64) + s1 + static_cast<limb>(hi) + static_cast<limb>(x12 >> 64);
+                s1 = static_cast<limb>(acc);
+                s2 = static_cast<limb>(acc >> 64) + static_cast<limb>(hi >> 64);
+            }
+            out[i] = s0;
+            c0 = s1;
+            c1 = s2;
+        }
+        return static_cast<dlimb>(c1) << 64 | c0;
+    }
+};
+
+//x = the transform of the residues of y[0..yn) zero padded to len points, in Montgomery form.
+static void ntt_transform(limb *x, const limb *y, std::size_t yn, std::size_t len, const limb *roots,
+                          const Modulus &md, ThreadPool *pool) {
+    for_blocks(pool, len, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) { x[i] = i < yn ? md.to_mont(y[i]) : 0; }
+    });
+    ntt_forward(x, len, roots, md, pool);
+}
+
+//len^-1 mod p as a plain value: multiplying a Montgomery value by it gives a plain value.
+static limb ntt_inverse_length(std::size_t len, const Modulus &md) {
+    return md.reduce(md.inverse(md.to_mont(len)));
+}
+
+//out[0..total) from the plain residues of the convolution modulo every prime, len apiece.
+static void ntt_recombine(const limb *res, std::size_t len, limb *out, std::size_t total, ThreadPool *pool) {
+    const Garner garner;
+    if (pool == nullptr || total <= NTT_BLOCK) {
+        garner.run(res, len, out, 0, total);
+        return;
+    }
+//    Every block resolves its own carries from zero, then the carry left by each block is added
+//    into the product from where the next block starts, in order.
+    const std::size_t blocks = (total + NTT_BLOCK - 1) / NTT_BLOCK;
+    std::vector<dlimb> carries(blocks);
+    pool->parallel_for(blocks, [&](std::size_t t) {
+        carries[t] = garner.run(res, len, out, t * NTT_BLOCK, std::min(total, (t + 1) * NTT_BLOCK));
+    });
+    for (std::size_t t = 0; t + 1 < blocks; t++) {
+        const std::size_t at = (t + 1) * NTT_BLOCK;
+        const limb c[2] = {static_cast<limb>(carries[t]), static_cast<limb>(carries[t] >> 64)};
+        kernel::add(out + at, out + at, total - at, c, std::min<std::size_t>(2, total - at));
+    }
+}
+
+void ntt_multiply(const limb *a, std::size_t n, const limb *b, std::size_t m, limb *out, ThreadPool *pool) {
+//    Convolve modulo every prime, the exact coefficients are below min(n, m) * 2^128 < p1 * p2 * p3.
+    const std::size_t len = std::bit_ceil(n + m - 1);
+    BIGINT_STAT_TIER(NTT);
+    const bool square = a == b && n == m;
+    memory::Scratch scratch;
+    limb *res = scratch.take<limb>(3 * len), *tmp = square ? nullptr : scratch.take<limb>(len);
+    limb *roots = scratch.take<limb>(len), *iroots = scratch.take<limb>(len);
+    BIGINT_STAT_ALLOC((square ? 5 : 6) * len * sizeof(limb));
+
+    for (int k = 0; k < 3; k++) {
+        const Modulus &md = MODULI[k];
+        limb *r = res + k * len;
+        ntt_roots(roots, len, md, false, pool);
+        ntt_roots(iroots, len, md, true, pool);
+
+        if (square) {
+            ntt_transform(r, a, n, len, roots, md, pool);
+            for_blocks(pool, len, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) { r[i] = md.mul(r[i], r[i]); }
+            });
+        } else {
+            if (pool != nullptr) {
+                pool->invoke([&] { ntt_transform(r, a, n, len, roots, md, pool); },
+                             [&] { ntt_transform(tmp, b, m, len, roots, md, pool); });
+            } else {
+                ntt_transform(r, a, n, len, roots, md, pool);
+                ntt_transform(tmp, b, m, len, roots, md, pool);
+            }
+            for_blocks(pool, len, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) { r[i] = md.mul(r[i], tmp[i]); }
+            });
+        }
+        ntt_inverse(r, len, iroots, md, pool);
+
+        const limb inv_len = ntt_inverse_length(len, md);
+        for_blocks(pool, len, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) { r[i] = md.mul(r[i], inv_len); }
+        });
+    }
+    ntt_recombine(res, len, out, n + m, pool);
+}
+
+void ntt_prepare(const limb *b, std::size_t m, std::size_t len, limb *prepared, ThreadPool *pool) {
+//    The transforms are kept as plain values already divided by len, so a pointwise product with a
+//    Montgomery transform is plain and scaled, and the inverse transform gives the residues.
+    memory::Scratch scratch;
+    limb *roots = scratch.take<limb>(len);
+    BIGINT_STAT_ALLOC(len * sizeof(limb));
+    for (int k = 0; k < 3; k++) {
+        const Modulus &md = MODULI[k];
+        limb *p = prepared + k * len;
+        ntt_roots(roots, len, md, false, pool);
+        ntt_transform(p, b, m, len, roots, md, pool);
+        const limb inv_len = ntt_inverse_length(len, md);
+        for_blocks(pool, len, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) { p[i] = md.mul(p[i], inv_len); }
+        });
+    }
+}
+
+void ntt_multiply_prepared(const limb *a, std::size_t n, const limb *prepared, std::size_t m, std::size_t len,
+                           limb *out, ThreadPool *pool) {
+//    ntt_multiply with the transform of b and the scaling pass already done.
+    BIGINT_STAT_TIER(NTT);
+    memory::Scratch scratch;
+    limb *res = scratch.take<limb>(3 * len), *roots = scratch.take<limb>(len), *iroots = scratch.take<limb>(len);
+    BIGINT_STAT_ALLOC(5 * len * sizeof(limb));
+
+    for (int k = 0; k < 3; k++) {
+        const Modulus &md = MODULI[k];
+        limb *r = res + k * len;
+        const limb *p = prepared + k * len;
+        ntt_roots(roots, len, md, false, pool);
+        ntt_roots(iroots, len, md, true, pool);
+        ntt_transform(r, a, n, len, roots, md, pool);
+        for_blocks(pool, len, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) { r[i] = md.mul(r[i], p[i]); }
+        });
+        ntt_inverse(r, len, iroots, md, pool);
+    }
+    ntt_recombine(res, len, out, n + m, pool);
+}
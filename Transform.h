@@ -0,0 +1,50 @@
+//
+//@brief: Definitions for the transform based multiplication engines used by BigInt.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+
+#ifndef BIGINT_TRANSFORM_H
+#define BIGINT_TRANSFORM_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+/**
+ *  Both engines multiply two magnitudes stored as base 2^64 limbs (least significant limb first)
+ * and write all n + m limbs of the product into out, which must not alias a or b.
+ *  fft_multiply splits every limb into small coefficients and runs a complex double FFT, so it is
+ * only exact while the rounding error of the transform stays below 0.5. Its roots of unity, the
+ * cubes of the radix 4 passes included, are each computed on their own rather than as products of
+ * other roots, which keeps the error near 10^-4 at 10^6 limbs. The roots of transforms of up to
+ * 2^20 points are cached (24 MiB at most), longer transforms compute theirs for the call.
+ *  ntt_multiply runs the same convolution modulo three 62-bit primes and recombines the residues
+ * with the Chinese remainder theorem, so it is exact for operands up to 2^54 limbs.
+ *  Given a pool, fft_multiply splits its wide radix 4 passes and then whole pieces of the transform
+ * across the pool's threads, and ntt_multiply also splits every butterfly stage, the pointwise
+ * products and the carry resolution.
+ */
+void fft_multiply(const std::uint64_t *a, std::size_t n, const std::uint64_t *b, std::size_t m,
+                  std::uint64_t *out, ThreadPool *pool = nullptr);
+
+void ntt_multiply(const std::uint64_t *a, std::size_t n, const std::uint64_t *b, std::size_t m,
+                  std::uint64_t *out, ThreadPool *pool = nullptr);
+
+//the transforms of b[0..m) at len points modulo the three primes into prepared[0..3 len), for any
+//number of products with it through ntt_multiply_prepared().
+void ntt_prepare(const std::uint64_t *b, std::size_t m, std::size_t len, std::uint64_t *prepared,
+                 ThreadPool *pool = nullptr);
+
+//ntt_multiply of a[0..n) by the factor of m limbs ntt_prepare() made prepared from, at len points
+//where len >= n + m - 1: one forward and one inverse transform per prime.
+void ntt_multiply_prepared(const std::uint64_t *a, std::size_t n, const std::uint64_t *prepared, std::size_t m,
+                           std::size_t len, std::uint64_t *out, ThreadPool *pool = nullptr);
+
+
+#endif //BIGINT_TRANSFORM_H
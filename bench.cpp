@@ -0,0 +1,210 @@
+//
+//@brief: Performance suite for BigInt, sweeping operand sizes over every operation.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+//Usage: bigint_bench [--min-digits N] [--max-digits N] [--min-time SECONDS] [--filter OP] [--json FILE]
+//Sizes go from 10 to 10^7 decimal digits by powers of ten. Every case runs in growing batches until one
+//batch takes --min-time (a batch may be a single run) and reports ns/op, limbs/s and heap allocations/op
+//of that batch. --json writes the results in a machine readable form ("-" for stdout, which moves the
+//table to stderr) so runs can be compared across versions.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "BigInt.h"
+
+using namespace std;
+
+static atomic<size_t> alloc_count(0);
+static atomic<size_t> alloc_bytes(0);
+
+void *operator new(size_t n) {
+//    Count every heap allocation, so the suite can report allocations per operation.
+    alloc_count.fetch_add(1, memory_order_relaxed);
+    alloc_bytes.fetch_add(n, memory_order_relaxed);
+    if (void *p = malloc(n == 0 ? 1 : n)) { return p; }
+    throw bad_alloc();
+}
+
+void *operator new[](size_t n) {
+    return operator new(n);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    free(p);
+}
+
+struct Result {
+    string op, shape;
+    size_t digits;
+    size_t iterations;
+    double ns_per_op;
+    double limbs_per_second;
+    double allocs_per_op;
+    double bytes_per_op;
+};
+
+static BigInt sink;                 // results are stored here so that no operation is optimized away
+static volatile size_t sink_value;
+static FILE *table = stdout;        // the human readable table, on stderr when the JSON takes stdout
+
+static string random_digits(size_t n, mt19937_64 &gen) {
+    string s(n, '0');
+    for (char &c : s) { c = static_cast<char>('0' + gen() % 10); }
+    s[0] = static_cast<char>('1' + gen() % 9);
+    return s;
+}
+
+//limbs needed by a number of n decimal digits.
+static size_t limbs_of(size_t digits) {
+    return static_cast<size_t>(digits * 0.05190512648261709) + 1;     // log2(10) / 64
+}
+
+//a case body run k times in a row, so that a batch costs one call and two clock reads.
+template<class F>
+static function<void(size_t)> repeat(F f) {
+    return [f](size_t k) {
+        for (size_t i = 0; i < k; i++) { f(); }
+    };
+}
+
+static Result measure(const string &op, const string &shape, size_t digits, size_t limbs, double min_time,
+                      const function<void(size_t)> &run) {
+//    Batches grow, aiming a little past min_time from the last one's pace, until one runs for min_time;
+//    that batch is reported, as Google Benchmark does.
+    size_t iterations = 1, allocs, bytes;
+    double elapsed;
+    while (true) {
+        allocs = alloc_count.load(memory_order_relaxed);
+        bytes = alloc_bytes.load(memory_order_relaxed);
+        auto start = chrono::steady_clock::now();
+        run(iterations);
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        allocs = alloc_count.load(memory_order_relaxed) - allocs;
+        bytes = alloc_bytes.load(memory_order_relaxed) - bytes;
+        if (elapsed >= min_time) { break; }
+        const double next = elapsed > 0 ? iterations * min_time * 1.4 / elapsed : iterations * 10.0;
+        iterations = max(iterations + 1, static_cast<size_t>(min(next, iterations * 10.0)));
+    }
+
+    Result r{op, shape, digits, iterations, elapsed * 1e9 / iterations,
+             static_cast<double>(limbs) * iterations / elapsed,
+             static_cast<double>(allocs) / iterations, static_cast<double>(bytes) / iterations};
+    fprintf(table, "%-6s %-10s %9zu %10zu %16.1f %14.4g %10.1f\n", op.c_str(), shape.c_str(), digits, iterations,
+            r.ns_per_op, r.limbs_per_second, r.allocs_per_op);
+    fflush(table);
+    return r;
+}
+
+static void write_json(ostream &out, const vector<Result> &results) {
+    out << "{\n  \"context\": {\"library\": \"BigInt\", \"version\": \"5.0.0\", \"multiply_engine\": \""
+        << (BigInt::multiply_engine() == BigInt::MultiplyEngine::NTT ? "NTT" : "FFT") << "\"},\n";
+    out << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        out << "    {\"name\": \"" << r.op << "/" << r.shape << "/" << r.digits << "\", \"op\": \"" << r.op
+            << "\", \"shape\": \"" << r.shape << "\", \"digits\": " << r.digits << ", \"iterations\": "
+            << r.iterations << ", \"ns_per_op\": " << r.ns_per_op << ", \"limbs_per_second\": "
+            << r.limbs_per_second << ", \"allocs_per_op\": " << r.allocs_per_op << ", \"bytes_per_op\": "
+            << r.bytes_per_op << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char **argv) {
+    size_t min_digits = 10, max_digits = 10000000;
+    double min_time = 0.2;
+    string filter, json;
+    for (int i = 1; i < argc; i += 2) {
+        const string option = argv[i];
+        if (option != "--min-digits" && option != "--max-digits" && option != "--min-time" && option != "--filter" &&
+            option != "--json") {
+            cerr << "unknown option " << option << endl;
+            return 1;
+        }
+        if (i + 1 == argc) {
+            cerr << "missing value for " << option << endl;
+            return 1;
+        }
+        const char *value = argv[i + 1];
+        if (option == "--min-digits") { min_digits = strtoull(value, nullptr, 10); }
+        else if (option == "--max-digits") { max_digits = strtoull(value, nullptr, 10); }
+        else if (option == "--min-time") { min_time = strtod(value, nullptr); }
+        else if (option == "--filter") { filter = value; }
+        else { json = value; }
+    }
+
+    mt19937_64 gen(2020);
+    vector<Result> results;
+    if (json == "-") { table = stderr; }
+    fprintf(table, "%-6s %-10s %9s %10s %16s %14s %10s\n", "op", "shape", "digits", "iters", "ns/op", "limbs/s", "allocs/op");
+    for (size_t n = 10; n <= max_digits; n *= 10) {
+        if (n < min_digits) { continue; }
+//        Balanced operands have the same length (the divisor half the dividend), unbalanced ones
+//        pair n digits with n / 16.
+        const string sa = random_digits(n, gen);
+        const BigInt a(sa), b(random_digits(n, gen)), half(random_digits(max<size_t>(n / 2, 1), gen));
+        const BigInt small(random_digits(max<size_t>(n / 16, 1), gen));
+        const BigInt same(sa), base("1234567891");
+        const size_t la = limbs_of(n), lh = limbs_of(max<size_t>(n / 2, 1)), ls = limbs_of(max<size_t>(n / 16, 1));
+
+        struct Case {
+            string op, shape;
+            size_t limbs;
+            function<void(size_t)> run;
+        };
+        vector<Case> cases = {
+                {"add", "balanced", 2 * la, repeat([&] { sink = a + b; })},
+                {"add", "unbalanced", la + ls, repeat([&] { sink = a + small; })},
+                {"sub", "balanced", 2 * la, repeat([&] { sink = a - b; })},
+                {"sub", "unbalanced", la + ls, repeat([&] { sink = a - small; })},
+                {"mul", "balanced", 2 * la, repeat([&] { sink = a * b; })},
+                {"mul", "unbalanced", la + ls, repeat([&] { sink = a * small; })},
+                {"div", "balanced", la + lh, repeat([&] { sink = a / half; })},
+                {"div", "unbalanced", la + ls, repeat([&] { sink = a / small; })},
+                {"mod", "balanced", la + lh, repeat([&] { sink = a % half; })},
+                {"mod", "unbalanced", la + ls, repeat([&] { sink = a % small; })},
+                {"pow", "balanced", la, repeat([&] { sink = pow(base, static_cast<int>(n / 9)); })},
+                {"cmp", "balanced", 2 * la, repeat([&] { sink_value = a < same; })},
+                {"cmp", "unbalanced", la + ls, repeat([&] { sink_value = a < small; })},
+                {"parse", "balanced", la, repeat([&] { sink = BigInt(sa); })},
+                {"print", "balanced", la, repeat([&] { sink_value = a.to_string().size(); })},
+        };
+        for (const Case &c : cases) {
+            if (!filter.empty() && c.op != filter) { continue; }
+            results.push_back(measure(c.op, c.shape, n, c.limbs, min_time, c.run));
+        }
+    }
+
+    if (json == "-") { write_json(cout, results); }
+    else if (!json.empty()) {
+        ofstream out(json);
+        write_json(out, results);
+    }
+    return 0;
+}
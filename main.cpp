@@ -21,28 +21,33 @@ int main() {
     cin >> a >> b;
 
     thread thread0([&a, &b] {
+        BigInt result = a + b;
         mu.lock();
-        cout << "a + b = " << a + b << endl;
+        cout << "a + b = " << result << endl;
         mu.unlock();
     });
     thread thread1([&a, &b] {
+        BigInt result = a - b;
         mu.lock();
-        cout << "a - b = " << a - b << endl;
+        cout << "a - b = " << result << endl;
         mu.unlock();
     });
     thread thread2([&a, &b] {
+        BigInt result = a * b;
         mu.lock();
-        cout << "a * b = " << a * b << endl;
+        cout << "a * b = " << result << endl;
         mu.unlock();
     });
     thread thread3([&a, &b] {
+        BigInt result = a / b;
         mu.lock();
-        cout << "a / b = " << a / b << endl;
+        cout << "a / b = " << result << endl;
         mu.unlock();
     });
     thread thread4([&a, &b] {
+        BigInt result = a % b;
         mu.lock();
-        cout << "a % b = " << a % b << endl;
+        cout << "a % b = " << result << endl;
         mu.unlock();
     });
 
@@ -0,0 +1,127 @@
+//
+//@brief: Regression tests for BigInt, run by ctest.
+//@copyright: Copyright NPU-Franklin 2020
+//@license: MIT License
+//@birth: created by NPU-Franklin 2026-10-18
+//@version: 5.0.0
+//@revision: last revised by NPU-Franklin 2026-10-18
+//
+//Every case prints one line and the program exits with the number of cases that failed.
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "BigInt.h"
+#include "Stats.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+static string random_digits(size_t n, mt19937_64 &gen) {
+    string s(n, '0');
+    for (char &c : s) { c = static_cast<char>('0' + gen() % 10); }
+    s[0] = static_cast<char>('1' + gen() % 9);
+    return s;
+}
+
+static int report(const char *name, bool ok) {
+    printf("%s %s\n", ok ? "ok  " : "FAIL", name);
+    return ok ? 0 : 1;
+}
+
+static int host_tasks_in_place() {
+//    Host tasks doing 'x *= y' share the pool with the forks of the products, so one of them can run
+//    on a thread that is inside the wait() of another product. Each must still get its own product
+//    and be counted as an operation of its own.
+    const size_t count = 200;
+    mt19937_64 gen(2020);
+    vector<BigInt> a, b, expected(count), result(count);
+    for (size_t i = 0; i < count; i++) {
+        size_t limbs = 200 + gen() % 3000;
+        a.emplace_back(random_digits(limbs * 19, gen));
+        b.emplace_back(random_digits(limbs * 19, gen));
+    }
+    BigInt::set_thread_pool(nullptr);
+    for (size_t i = 0; i < count; i++) { expected[i] = a[i] * b[i]; }
+
+    auto pool = make_shared<ThreadPool>(4);
+    BigInt::set_thread_pool(pool);
+    stats::reset();
+    stats::enable(true);
+    {
+        TaskGroup tasks(pool.get());
+        for (size_t i = 0; i < count; i++) {
+            tasks.run([&, i] {
+                BigInt x = a[i];
+                x *= b[i];
+                result[i] = std::move(x);
+            });
+        }
+        tasks.wait();
+    }
+    stats::enable(false);
+    const uint64_t products = stats::snapshot().ops[static_cast<int>(stats::Op::Mul)].calls;
+    BigInt::set_thread_pool(nullptr);
+    BigInt::set_thread_count(0);
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < count; i++) { wrong += result[i] != expected[i]; }
+    return report("host tasks multiplying in place", wrong == 0)
+           + report("host tasks counted as operations", products == count);
+}
+
+static int products_across_tiers() {
+//    Products with lowered thresholds, so that a few hundred limbs go through every tier and the
+//    unbalanced slicing, against the same products with the schoolbook method alone. Squares take
+//    their own paths at each tier and are checked too.
+    const size_t count = 300;
+    mt19937_64 gen(2026);
+    vector<BigInt> a, b, expected(count), squares(count);
+    for (size_t i = 0; i < count; i++) {
+        const size_t n = 1 + gen() % 400, m = gen() % 4 == 0 ? 1 + gen() % 40 : 1 + gen() % 400;
+        a.emplace_back((gen() % 2 ? "-" : "") + random_digits(n * 19, gen));
+        b.emplace_back((gen() % 2 ? "-" : "") + random_digits(m * 19, gen));
+    }
+    const BigInt::MultiplyThresholds saved = BigInt::multiply_thresholds();
+    const BigInt::MultiplyEngine engine = BigInt::multiply_engine();
+
+    BigInt::MultiplyThresholds schoolbook;
+    schoolbook.karatsuba = schoolbook.toom3 = schoolbook.transform = schoolbook.parallel = SIZE_MAX;
+    BigInt::set_multiply_thresholds(schoolbook);
+    for (size_t i = 0; i < count; i++) {
+        expected[i] = a[i] * b[i];
+        squares[i] = a[i] * a[i];
+    }
+
+    BigInt::MultiplyThresholds low;
+    low.karatsuba = 8;
+    low.toom3 = 24;
+    low.transform = 96;
+    low.parallel = SIZE_MAX;
+    BigInt::set_multiply_thresholds(low);
+    int failed = 0;
+    for (BigInt::MultiplyEngine e : {BigInt::MultiplyEngine::NTT, BigInt::MultiplyEngine::FFT}) {
+        BigInt::set_multiply_engine(e);
+        size_t wrong = 0;
+        for (size_t i = 0; i < count; i++) {
+            wrong += a[i] * b[i] != expected[i];
+            wrong += a[i].square() != squares[i];
+        }
+        failed += report(e == BigInt::MultiplyEngine::NTT ? "products across tiers, NTT engine"
+                                                          : "products across tiers, FFT engine", wrong == 0);
+    }
+    BigInt::set_multiply_engine(engine);
+    BigInt::set_multiply_thresholds(saved);
+    return failed;
+}
+
+int main() {
+    int failed = 0;
+    failed += products_across_tiers();
+    failed += host_tasks_in_place();
+    return failed;
+}